@@ -0,0 +1,136 @@
+/*
+ * Bus-wide ILC mode transitions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_BusModeTransition_h
+#define _cRIO_BusModeTransition_h
+
+#include <cstdint>
+#include <vector>
+
+#include <cRIO/FPGA.h>
+#include <cRIO/ILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Transitions all ILCs on buses into target mode. Standby, Disabled and
+ * Enabled modes are traversed step by step (Standby -> Disabled -> Enabled
+ * and back), other modes are changed directly. ILCs in Fault mode are first
+ * commanded to ClearFaults.
+ *
+ * On buses with broadcast enabled, a step shared by all bus ILCs is
+ * commanded with a single mode change broadcast, followed in the same FPGA
+ * transaction by server status requests verifying the ILCs reached the
+ * step mode. ILCs which didn't (as their firmware doesn't support broadcast
+ * mode change, or broadcast was lost) are commanded with unicast
+ * changeILCMode. Steps with ILCs in different modes are always commanded
+ * with unicasts. All buses are commanded in parallel.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * BusModeTransition transition(fpga);
+ * transition.addBus(&busA, {1, 2, 3, 4}, true, 248);
+ * transition.addBus(&busB, {1, 2, 3}, true, 248);
+ * transition.transition(ILC::Enabled);
+ * @endcode
+ */
+class BusModeTransition {
+public:
+    /**
+     * Transition statistics, reset at transition start.
+     */
+    struct Statistics {
+        // number of FPGA transactions
+        unsigned int transactions = 0;
+        // number of mode change broadcasts
+        unsigned int broadcasts = 0;
+        // number of unicast mode changes
+        unsigned int unicasts = 0;
+    };
+
+    /**
+     * Construct transition.
+     *
+     * @param fpga FPGA used to communicate with ILCs
+     */
+    BusModeTransition(FPGA* fpga);
+
+    /**
+     * Adds bus to transition.
+     *
+     * @param ilc bus ILC. Its buffer is cleared and used for transition commands.
+     * Missing replies shall be tolerated (ILC::setTolerateMissing) to
+     * transition other ILCs if some ILC doesn't reply
+     * @param addresses addresses of ILCs on the bus. Shall include all ILCs
+     * responding to the broadcast address, if broadcast is enabled
+     * @param broadcast if true, broadcast mode changes are used
+     * @param broadcastAddress mode change broadcast address
+     */
+    void addBus(ILC* ilc, std::vector<uint8_t> addresses, bool broadcast = false,
+                uint8_t broadcastAddress = 250);
+
+    /**
+     * Transition ILCs on all buses into target mode.
+     *
+     * @param mode target mode
+     * @param maxSteps maximal number of transition steps
+     *
+     * @throw std::runtime_error if any ILC doesn't reach target mode in
+     * maxSteps, or on communication error. ILCs which never reported their
+     * mode aren't commanded, and are reported in the exception
+     */
+    void transition(uint8_t mode, int maxSteps = 8);
+
+    const Statistics& getStatistics() { return _statistics; }
+
+    /**
+     * Returns next mode on the path from current into target mode.
+     *
+     * @param current current ILC mode
+     * @param target target ILC mode
+     *
+     * @return mode to command
+     */
+    static uint8_t nextMode(uint8_t current, uint8_t target);
+
+private:
+    struct Bus {
+        ILC* ilc;
+        std::vector<uint8_t> addresses;
+        bool broadcast;
+        uint8_t broadcastAddress;
+    };
+
+    FPGA* _fpga;
+    std::vector<Bus> _buses;
+
+    Statistics _statistics;
+
+    void _commands(const std::vector<ILC*>& ilcs);
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_BusModeTransition_h
@@ -0,0 +1,166 @@
+/*
+ * Bus time budget planner.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_BusPlanner_h
+#define _cRIO_BusPlanner_h
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Plans bus cycles within time budget. Worst case wire time of every queued
+ * call is estimated from the function request and reply lengths, reply
+ * timeout (or broadcast delay) and bus baud rate. Calls are admitted into
+ * cycle in priority order until the cycle budget is spent; the remaining
+ * calls are deferred to the next cycles.
+ *
+ * Timings of generic ILC functions and the most common actuator ILC
+ * functions are predefined, using the reply timeouts the ILC classes call the
+ * functions with; other functions shall be specified with setFunctionTiming.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * BusPlanner planner(2000000, std::chrono::milliseconds(20));
+ * planner.queue(10, 76, [&ilc]() { ilc.reportForceStatus(17); });
+ * planner.queue(0, 18, [&ilc]() { ilc.reportServerStatus(17); });
+ *
+ * ilc.clear();
+ * planner.planCycle();
+ * fpga.ilcCommands(ilc);
+ * @endcode
+ */
+class BusPlanner {
+public:
+    /**
+     * Planning statistics.
+     */
+    struct Statistics {
+        // number of planned cycles
+        uint64_t cycles = 0;
+        // number of admitted calls
+        uint64_t admitted = 0;
+        // number of times a call was deferred to the next cycle
+        uint64_t deferrals = 0;
+        // number of cycles with at least one deferred call
+        uint64_t deferredCycles = 0;
+        // maximal number of calls left queued after cycle planning
+        size_t maxBacklog = 0;
+        // maximal planned cycle wire time
+        std::chrono::nanoseconds maxPlanned = std::chrono::nanoseconds::zero();
+    };
+
+    /**
+     * Construct planner.
+     *
+     * @param baudRate bus baud rate (bits/second)
+     * @param budget maximal wire time of a cycle
+     */
+    BusPlanner(uint32_t baudRate, std::chrono::nanoseconds budget);
+
+    /**
+     * Sets function timing.
+     *
+     * @param func function code
+     * @param requestLength request length, including address, function code and CRC (bytes)
+     * @param replyLength reply length, including address, function code and CRC (bytes). 0 for broadcast
+     * @param timeout reply timeout or broadcast delay (us)
+     */
+    void setFunctionTiming(uint8_t func, size_t requestLength, size_t replyLength, uint32_t timeout);
+
+    /**
+     * Estimates worst case wire time of a function call. Includes request and
+     * reply transfer, inter-frame gaps and reply timeout (or broadcast delay).
+     *
+     * @param func function code
+     *
+     * @return estimated wire time
+     *
+     * @throw std::out_of_range if function timing isn't known
+     */
+    std::chrono::nanoseconds estimate(uint8_t func);
+
+    /**
+     * Queues call.
+     *
+     * @param priority call priority. Calls with higher priority are
+     * admitted first, calls with the same priority in the queue order
+     * @param func called function code
+     * @param call action writing the call into ILC buffer
+     *
+     * @throw std::out_of_range if function timing isn't known, or the call
+     * estimated time exceeds the cycle budget
+     */
+    void queue(int priority, uint8_t func, std::function<void()> call);
+
+    /**
+     * Plans the next cycle. Admitted calls are removed from queue and their
+     * actions are executed.
+     *
+     * @return planned wire time of the cycle
+     */
+    std::chrono::nanoseconds planCycle();
+
+    /**
+     * Returns number of queued calls.
+     */
+    size_t getBacklog() { return _queue.size(); }
+
+    const Statistics& getStatistics() { return _statistics; }
+
+    void resetStatistics() { _statistics = Statistics(); }
+
+private:
+    struct Timing {
+        size_t requestLength = 0;
+        size_t replyLength = 0;
+        uint32_t timeout = 0;
+        bool known = false;
+    };
+
+    struct Call {
+        int priority;
+        std::chrono::nanoseconds estimate;
+        std::function<void()> call;
+    };
+
+    uint32_t _baudRate;
+    std::chrono::nanoseconds _budget;
+
+    Timing _timings[256];
+
+    // queued calls, ordered by priority
+    std::list<Call> _queue;
+
+    Statistics _statistics;
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_BusPlanner_h
@@ -0,0 +1,118 @@
+/*
+ * Telemetry change filter.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_ChangeFilter_h
+#define _cRIO_ChangeFilter_h
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Filters changes in telemetry values received from a single function. Values
+ * shall be published only when a value changes by more than its deadband, or
+ * when maximal publish interval elapsed. Last published values and
+ * publication time are stored for each (ILC) address.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * ChangeFilter filter;
+ * filter.setDeadband(1, 0.5);
+ * filter.setPublishIntervals(100ms, 1s);
+ *
+ * double values[2] = {status, force};
+ * if (filter.changed(address, values, 2, std::chrono::steady_clock::now())) {
+ *     publish(status, force);
+ * }
+ * @endcode
+ */
+class ChangeFilter {
+public:
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    ChangeFilter();
+
+    /**
+     * Sets field deadband. Changes smaller or equal to the deadband are not
+     * considered as changes. Fields without deadband are considered as changed
+     * on any value change.
+     *
+     * @param field field index (0 based)
+     * @param deadband absolute or relative deadband
+     * @param relative if true, deadband is a fraction of the last published value
+     */
+    void setDeadband(size_t field, double deadband, bool relative = false);
+
+    /**
+     * Sets publish intervals.
+     *
+     * @param minInterval values are not published more often than this,
+     * regardless of the change size. 0 for no limit
+     * @param maxInterval values are published at least with this interval,
+     * even if they didn't change. 0 to publish only on change
+     */
+    void setPublishIntervals(std::chrono::steady_clock::duration minInterval,
+                             std::chrono::steady_clock::duration maxInterval);
+
+    /**
+     * Checks values for changes. If values shall be published, stores them
+     * as the last published values.
+     *
+     * @param address device (ILC) address
+     * @param values new values
+     * @param count number of values
+     * @param now current time
+     *
+     * @return true if the values shall be published
+     */
+    bool changed(uint8_t address, const double* values, size_t count, time_point now);
+
+private:
+    struct Deadband {
+        double deadband = 0;
+        bool relative = false;
+    };
+
+    std::vector<Deadband> _deadbands;
+
+    std::chrono::steady_clock::duration _minInterval;
+    std::chrono::steady_clock::duration _maxInterval;
+
+    // number of values stored per address
+    size_t _count;
+
+    // last published values, indexed by address * _count + field
+    std::vector<double> _lastValues;
+
+    // last publication time, time_point::min() if never published
+    std::vector<time_point> _lastPublished;
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_ChangeFilter_h
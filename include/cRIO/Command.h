@@ -24,6 +24,7 @@
 #ifndef COMMAND_H_
 #define COMMAND_H_
 
+#include <chrono>
 #include <string>
 
 namespace LSST {
@@ -40,8 +41,68 @@ namespace cRIO {
  */
 class Command {
 public:
+    /**
+     * Priority of commands executed as soon as possible (panic, disable,..).
+     */
+    static constexpr int PRIORITY_URGENT = 100;
+
+    /**
+     * Default command priority.
+     */
+    static constexpr int PRIORITY_NORMAL = 0;
+
+    /**
+     * Priority of commands which can wait for all other commands.
+     */
+    static constexpr int PRIORITY_HOUSEKEEPING = -100;
+
+    Command(int priority = PRIORITY_NORMAL);
     virtual ~Command();
 
+    /**
+     * Returns command priority. Commands with higher priority are executed
+     * first; commands with the same priority are executed in enqueue order.
+     */
+    int getPriority() const { return _priority; }
+
+    /**
+     * Sets command priority. Shall be called before the command is enqueued -
+     * changes made after enqueue might be ignored.
+     *
+     * @param priority new command priority
+     */
+    void setPriority(int priority) { _priority = priority; }
+
+    /**
+     * Sets deadline of command execution. If the command isn't started before
+     * the deadline, it is not executed and ackFailed is called.
+     *
+     * @param deadline command deadline
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline) { _deadline = deadline; }
+
+    /**
+     * Sets deadline relative to now.
+     *
+     * @param timeout time from now the command shall be started
+     */
+    void setTimeout(std::chrono::steady_clock::duration timeout) {
+        setDeadline(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /**
+     * Returns command deadline. Defaults to steady_clock::time_point::max()
+     * - no deadline.
+     */
+    std::chrono::steady_clock::time_point getDeadline() const { return _deadline; }
+
+    /**
+     * Returns true if command deadline has passed.
+     *
+     * @param now current time
+     */
+    bool isExpired(std::chrono::steady_clock::time_point now) const { return now > _deadline; }
+
     /**
      * Validates the command.
      *
@@ -69,6 +130,15 @@ public:
      * @param[in] reason The reason why the command has failed.
      */
     virtual void ackFailed(std::string reason);
+
+private:
+    friend class ControllerThread;
+
+    int _priority;
+    std::chrono::steady_clock::time_point _deadline;
+
+    // next command in ControllerThread queue
+    Command* _next = nullptr;
 };
 
 }  // namespace cRIO
@@ -22,7 +22,10 @@
 #ifndef CONTROLLERTHREAD_H_
 #define CONTROLLERTHREAD_H_
 
+#include <atomic>
+#include <cstdint>
 #include <queue>
+#include <vector>
 
 #include <cRIO/Command.h>
 #include <cRIO/Singleton.h>
@@ -39,13 +42,25 @@ namespace cRIO {
  * to the Controller::_execute method. Singleton, as only a single instance
  * should occur in an application. Runs in a single thread - provides guarantee
  * that only a single command is being executed at any moment.
+ *
+ * Commands are executed in priority order, commands with the same priority in
+ * enqueue order. Newly enqueued commands are considered after every executed
+ * command, so an urgent command waits at most for the currently executed
+ * command. Commands whose deadline has passed are not executed.
+ *
+ * Lower priority commands are executed only when no higher priority command
+ * is pending - housekeeping commands can be starved by steady traffic of
+ * normal priority commands. Set a deadline on them if they shall rather
+ * fail than wait indefinitely.
  */
 class ControllerThread final : public Thread, public Singleton<ControllerThread> {
 public:
     ControllerThread(token);
     ~ControllerThread();
 
-    /* Put command into queue.
+    /* Put command into queue. Never blocks on command execution - commands
+     * are executed without runMutex held, and the lock is taken only to wake
+     * up the sleeping controller thread.
      *
      * @param command Command to enqueue. ControllerThread takes ownership of
      * the passed Command and will dispose it (delete it) after command is
@@ -65,7 +80,34 @@ private:
     void _clear();
     void _execute(Command* command);
 
-    std::queue<Command*> _queue;
+    Command* _dequeueAll();
+    void _pull();
+
+    // lock-free multi-producer single-consumer queue - LIFO stack of
+    // commands linked through Command::_next, reversed by the consumer
+    std::atomic<Command*> _head;
+    // true when controller thread waits (or is about to wait) for commands
+    std::atomic<bool> _sleeping;
+
+    // priority is copied when the command is pulled, as Command::setPriority
+    // can be called from other threads
+    struct Pending {
+        Command* command;
+        int priority;
+        uint64_t sequence;
+
+        bool operator<(const Pending& other) const {
+            if (priority != other.priority) {
+                return priority < other.priority;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    // commands waiting for execution, accessed only from controller thread
+    std::priority_queue<Pending, std::vector<Pending>> _pending;
+    uint64_t _sequence;
+
     bool _exitRequested;
 };
 
@@ -0,0 +1,121 @@
+/*
+ * Discovery of ILCs present on buses.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_Discovery_h
+#define _cRIO_Discovery_h
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cRIO/FPGA.h>
+#include <cRIO/ILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Scans buses for ILCs. Addresses are probed with server ID (function 17)
+ * requests. Requests are batched - single FPGA transaction probes multiple
+ * addresses on all buses. Reply timeout is shortened, and missing replies
+ * are tolerated.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * Discovery discovery(fpga, {1, 2, 3, 4, 5});
+ * for (auto id : discovery.scan()) {
+ *     std::cout << +id.bus << ":" << +id.address << " " << id.firmwareName << std::endl;
+ * }
+ * @endcode
+ */
+class Discovery {
+public:
+    /**
+     * Server ID of discovered ILC.
+     */
+    struct ServerID {
+        uint8_t bus;
+        uint8_t address;
+        uint64_t uniqueID;
+        uint8_t ilcAppType;
+        uint8_t networkNodeType;
+        uint8_t ilcSelectedOptions;
+        uint8_t networkNodeOptions;
+        uint8_t majorRev;
+        uint8_t minorRev;
+        std::string firmwareName;
+    };
+
+    /**
+     * Construct discovery.
+     *
+     * @param fpga FPGA used to communicate with ILCs
+     * @param buses buses (1 based) to scan
+     */
+    Discovery(FPGA* fpga, std::vector<uint8_t> buses);
+
+    /**
+     * Sets number of addresses probed on every bus in a single transaction.
+     *
+     * @param batchSize number of addresses in a transaction. Defaults to 64
+     */
+    void setBatchSize(size_t batchSize) { _batchSize = batchSize; }
+
+    /**
+     * Sets reply timeout. Shall be long enough for the ILC to start its
+     * reply.
+     *
+     * @param timeout reply timeout in us (microseconds). Defaults to 300
+     */
+    void setReplyTimeout(uint32_t timeout) { _replyTimeout = timeout; }
+
+    /**
+     * Scan buses. Communication error on a bus stops scan of that bus, other
+     * buses are still scanned. Errors are available from getErrors.
+     *
+     * @param firstAddress first probed address
+     * @param lastAddress last probed address
+     *
+     * @return server IDs of ILCs found on the buses, ordered by bus and address
+     */
+    std::vector<ServerID> scan(uint8_t firstAddress = 1, uint8_t lastAddress = 247);
+
+    /**
+     * Returns errors of the last scan.
+     *
+     * @return bus -> error message of buses which scan failed
+     */
+    const std::map<uint8_t, std::string>& getErrors() const { return _errors; }
+
+private:
+    FPGA* _fpga;
+    std::vector<uint8_t> _buses;
+    size_t _batchSize;
+    uint32_t _replyTimeout;
+    std::map<uint8_t, std::string> _errors;
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_Discovery_h
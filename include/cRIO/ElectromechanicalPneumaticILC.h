@@ -23,6 +23,9 @@
 #ifndef _cRIO_ElectromechanicalPneumaticILC_h
 #define _cRIO_ElectromechanicalPneumaticILC_h
 
+#include <bitset>
+
+#include <cRIO/DataTypes.h>
 #include <cRIO/ILC.h>
 
 namespace LSST {
@@ -31,6 +34,10 @@ namespace cRIO {
 /**
  * Class for communication with Electromechanical and Pneumatic ILCs.
  *
+ * Hardpoint index (0 based, up to HP_COUNT) shall be assigned to hardpoint
+ * ILC addresses with setHardpoint() for broadcast step motor move and LVDT
+ * readout aggregation.
+ *
  * Replies received from ILCs shall be processed with ILC::processResponse method.
  */
 class ElectromechanicalPneumaticILC : public virtual ILC {
@@ -42,12 +49,47 @@ public:
      */
     ElectromechanicalPneumaticILC(uint8_t bus = 1);
 
+    /**
+     * Reply timeout (us) of hardpoint and mezzanine functions.
+     */
+    static constexpr uint32_t HARDPOINT_TIMEOUT = 1800;
+
+    /**
+     * Assign hardpoint index to ILC address.
+     *
+     * @param address ILC address
+     * @param index hardpoint index (0 based, less than HP_COUNT)
+     *
+     * @throw std::out_of_range if address or index is out of range
+     */
+    void setHardpoint(uint8_t address, int index);
+
+    /**
+     * Unicast step motor move. ILC command code 66 (0x42). Response is
+     * processed as response to command 67 (0x43).
+     *
+     * @param address ILC address
+     * @param steps number of steps to move (signed, -100..100)
+     */
+    void setStepperSteps(uint8_t address, int8_t steps) {
+        callFunction(address, 66, HARDPOINT_TIMEOUT, steps);
+    }
+
+    /**
+     * Broadcast step motor move to all hardpoints on the bus. ILC command
+     * code 66 (0x42) to broadcast address 249. Steps of all hardpoints are
+     * encoded in a single frame, ordered by hardpoint index.
+     *
+     * @param steps number of steps to move, indexed by hardpoint index
+     */
+    void broadcastStepperSteps(const int8_t steps[HP_COUNT]);
+
     /**
      * Unicast Hardpoint ILC Force [N] and Status Request. ILC command code 67 (0x43)
      *
      * @param address ILC address
      */
-    void reportHardpointForceStatus(uint8_t address) { callFunction(address, 67, 1800); }
+    void reportHardpointForceStatus(uint8_t address) { callFunction(address, 67, HARDPOINT_TIMEOUT); }
 
     /**
      * Unicast ADC Channel Offset and Sensitivity. ILC command code 81 (0x51)
@@ -66,18 +108,27 @@ public:
      *
      * @param address ILC address
      */
-    void reportCalibrationData(uint8_t address) { callFunction(address, 110, 1800); }
+    void reportCalibrationData(uint8_t address) { callFunction(address, 110, HARDPOINT_TIMEOUT); }
 
     /**
      * Read ILC mezzanine pressure. ILC command code 119 (0x77).
      *
      * @param address ILC address
      */
-    void reportMezzaninePressure(uint8_t address) { callFunction(address, 119, 1800); }
+    void reportMezzaninePressure(uint8_t address) { callFunction(address, 119, HARDPOINT_TIMEOUT); }
+
+    /**
+     * Read DCP mezzanine board LVDT instruments. ILC command code 122 (0x7a).
+     *
+     * @param address ILC address
+     */
+    void reportLVDT(uint8_t address) { callFunction(address, 122, HARDPOINT_TIMEOUT); }
 
 protected:
     /**
-     * Called when response from call to command 67 (0x43) is read.
+     * Called when response from call to command 66 (0x42) or 67 (0x43) is
+     * read. Fields for change filtering (see ILC::setDeadband) are status
+     * (0), encoder position (1) and load cell force (2).
      *
      * @param address returned from this ILC
      * @param status hardpoint Status
@@ -102,8 +153,58 @@ protected:
                                         float mainSensitivity[4], float backupADCK[4], float backupOffset[4],
                                         float backupSensitivity[4]) = 0;
 
+    /**
+     * Called when response from call to command 119 (0x77) is read. Fields
+     * for change filtering (see ILC::setDeadband) are primary push (0),
+     * primary pull (1), secondary push (2) and secondary pull (3) pressures.
+     *
+     * @param address returned from this ILC
+     * @param primaryPush primary cylinder push pressure
+     * @param primaryPull primary cylinder pull pressure
+     * @param secondaryPush secondary cylinder push pressure
+     * @param secondaryPull secondary cylinder pull pressure
+     */
     virtual void processMezzaninePressure(uint8_t address, float primaryPush, float primaryPull,
                                           float secondaryPush, float secondaryPull) = 0;
+
+    /**
+     * Called when response from call to command 122 (0x7a) is read. Fields
+     * for change filtering (see ILC::setDeadband) are breakaway (0) and
+     * displacement (1) LVDT. Default implementation does nothing.
+     *
+     * @param address returned from this ILC
+     * @param breakawayLVDT breakaway LVDT reading
+     * @param displacementLVDT displacement LVDT reading
+     */
+    virtual void processHardpointLVDT(uint8_t address, float breakawayLVDT, float displacementLVDT) {}
+
+    /**
+     * Called at the end of bus cycle if LVDT of any hardpoint with assigned
+     * index was read during the cycle. Values of hardpoints not read in the
+     * cycle are NaN.
+     *
+     * @param breakawayLVDT breakaway LVDT readings, indexed by hardpoint index
+     * @param displacementLVDT displacement LVDT readings, indexed by hardpoint index
+     */
+    virtual void processHardpointLVDTs(const float breakawayLVDT[HP_COUNT],
+                                       const float displacementLVDT[HP_COUNT]) {}
+
+    /**
+     * Returns hardpoint index assigned to the address.
+     *
+     * @param address ILC address
+     *
+     * @return hardpoint index, -1 if no hardpoint is assigned to the address
+     */
+    int getHardpoint(uint8_t address) { return _hpIndex[address]; }
+
+private:
+    // hardpoint indices, indexed by ILC address
+    int _hpIndex[256];
+
+    float _breakawayLVDT[HP_COUNT];
+    float _displacementLVDT[HP_COUNT];
+    std::bitset<HP_COUNT> _lvdtReported;
 };
 
 }  // namespace cRIO
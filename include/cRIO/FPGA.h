@@ -23,6 +23,8 @@
 #ifndef CRIO_FPGA_H_
 #define CRIO_FPGA_H_
 
+#include <exception>
+#include <map>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -115,7 +117,8 @@ public:
     virtual uint32_t getIrq(uint8_t bus) = 0;
 
     /**
-     * Send commands from ILC.
+     * Send commands from ILC. ILC::endOfCycle is called after all responses
+     * are processed.
      *
      * @param ilc ILC class. That contains ModbusBuffer with commands. Its
      * ILC::getBus() method returns bus used for communication.
@@ -126,8 +129,39 @@ public:
      */
     void ilcCommands(ILC& ilc);
 
+    /**
+     * Send commands from multiple ILCs. Commands for all ILCs are written
+     * before any response is read, so buses are serviced concurrently.
+     * ILC::endOfCycle is called for every ILC after its responses are
+     * processed. Responses of all ILCs are read even if processing of an ILC
+     * responses fails, so the FPGA FIFOs are left in consistent state.
+     *
+     * @param ilcs ILCs to command. Each ILC shall use different bus
+     * @param timeout timeout for bus transaction (ms)
+     * @param errors if not NULL, exceptions raised while reading or
+     * processing ILC responses are stored in the map and not thrown
+     *
+     * @throw std::runtime_error if two ILCs use the same bus
+     *
+     * @see ilcCommands(ILC&)
+     */
+    void ilcCommands(std::vector<ILC*> ilcs, uint32_t timeout = 5000,
+                     std::map<ILC*, std::exception_ptr>* errors = NULL);
+
     void mpuCommands(MPU& mpu);
 
+    /**
+     * Send commands from multiple MPUs. Programs for MPUs on different buses
+     * are written back to back, so the MPUs execute them concurrently. Output
+     * is then read from all MPUs whose programs contain read. MPUs on the same
+     * bus are processed in the order they are passed.
+     *
+     * @param mpus MPUs to command
+     *
+     * @see mpuCommands(MPU&)
+     */
+    void mpuCommands(std::vector<MPU*> mpus);
+
     /**
      * Commands FPGA to write to MPU commands buffer.
      *
@@ -222,6 +256,9 @@ protected:
 
 private:
     uint16_t _modbusSoftwareTrigger;
+
+    void _writeILCCommands(ILC& ilc);
+    void _readILCResponses(ILC& ilc);
 };
 
 }  // namespace cRIO
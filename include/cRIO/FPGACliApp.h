@@ -72,6 +72,9 @@ public:
     int closeFPGA(command_vec cmds);
     int openFPGA(command_vec cmds);
     int programILC(command_vec cmds);
+    int programPages(command_vec cmds);
+    int programTarget(command_vec cmds);
+    int programForce(command_vec cmds);
     int verbose(command_vec cmds);
 
 protected:
@@ -139,6 +142,14 @@ private:
 
     bool _autoOpen;
     bool _timeIt;
+
+    // number of firmware pages written in a single transaction
+    size_t _programPages;
+
+    // ILCs running target firmware aren't programmed, unless forced
+    bool _programTargetSet;
+    ILC::FirmwareRevision _programTarget;
+    bool _programForce;
 };
 
 }  // namespace cRIO
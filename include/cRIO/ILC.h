@@ -23,8 +23,12 @@
 #ifndef _cRIO_ILC_
 #define _cRIO_ILC_
 
+#include <chrono>
 #include <map>
+#include <memory>
+#include <vector>
 
+#include <cRIO/ChangeFilter.h>
 #include <cRIO/ModbusBuffer.h>
 #include <cRIO/IntelHex.h>
 
@@ -102,19 +106,121 @@ public:
      */
     void setAlwaysTrigger(bool newAlwaysTrigger) { _alwaysTrigger = newAlwaysTrigger; }
 
+    /**
+     * Sets response change detection mode. By default, only hash of the
+     * responses is cached and compared. Full compare stores and compares all
+     * response bytes.
+     *
+     * @param fullCompare if true, full response is stored and compared
+     *
+     * @see responseMatchCached
+     */
+    void setFullCompare(bool fullCompare) { setHashRecording(!fullCompare); }
+
+    /**
+     * Sets deadband for telemetry field. Responses of the function trigger
+     * callback only if any field changes by more than its deadband, or when
+     * maximal publish interval elapsed. Fields of the function are documented
+     * in the classes handling the function.
+     *
+     * @param func function code
+     * @param field field index (0 based)
+     * @param deadband absolute or relative deadband
+     * @param relative if true, deadband is a fraction of the last published value
+     *
+     * @see ChangeFilter::setDeadband
+     */
+    void setDeadband(uint8_t func, size_t field, double deadband, bool relative = false);
+
+    /**
+     * Sets minimal and maximal publish intervals of function responses.
+     *
+     * @param func function code
+     * @param minInterval callback isn't called more often than this. 0 for no limit
+     * @param maxInterval callback is called at least with this interval. 0
+     * to call callback only on change
+     *
+     * @see ChangeFilter::setPublishIntervals
+     */
+    void setPublishIntervals(uint8_t func, std::chrono::steady_clock::duration minInterval,
+                             std::chrono::steady_clock::duration maxInterval);
+
+    /**
+     * Enables reply timeouts learned from measured response times. When
+     * enabled, response times of every (address, function, requested
+     * timeout) triplet are recorded, so calls requesting unusually long
+     * timeouts (e.g. mode change to firmware update) are learned separately.
+     * Once enough responses are recorded, calls to the function use the
+     * measured response time percentile plus margin as reply timeout, bounded
+     * by floor and ceiling. Until then, the default function timeout is used.
+     * Every missed reply doubles the learned timeout; the widening decays by
+     * half with every received reply.
+     *
+     * @param learn true to enable learned timeouts
+     * @param floor minimal timeout (us)
+     * @param ceiling maximal timeout (us). Requested timeouts above ceiling
+     * are used as the bound for their calls
+     * @param percentile response time percentile (0-1)
+     * @param margin margin added to the percentile (us)
+     *
+     * @see reportResponseTime
+     */
+    void setLearnedTimeouts(bool learn, uint32_t floor = 100, uint32_t ceiling = 100000,
+                            float percentile = 0.99, uint32_t margin = 200);
+
+    /**
+     * Records response time of the last processed response. Called by
+     * FPGA::ilcCommands with FPGA timestamps. The time includes request and
+     * response transfer, so learned timeouts are slightly conservative.
+     *
+     * @param begin timestamp of the request start (ns)
+     * @param end timestamp of the response end (ns)
+     */
+    void reportResponseTime(uint64_t begin, uint64_t end);
+
+    /**
+     * Returns number of replies missed since learned timeouts were enabled.
+     *
+     * @param address ILC address
+     * @param function ILC function
+     *
+     * @return number of calls without reply
+     */
+    uint32_t getResponseTimeouts(uint8_t address, uint8_t function);
+
+    /**
+     * Called after all responses of a bus cycle (FPGA transaction) were
+     * processed. Runs actions registered with addEndOfCycleAction.
+     *
+     * @see FPGA::ilcCommands
+     */
+    void endOfCycle();
+
+    /**
+     * Reply timeouts (us) of generic ILC functions. Used for calls and
+     * BusPlanner wire time estimates.
+     */
+    static constexpr uint32_t SERVER_ID_TIMEOUT = 835;
+    static constexpr uint32_t SERVER_STATUS_TIMEOUT = 270;
+    static constexpr uint32_t CHANGE_MODE_TIMEOUT = 335;
+    // Standby <-> FirmwareUpdate mode change
+    static constexpr uint32_t FIRMWARE_UPDATE_MODE_TIMEOUT = 100000;
+    static constexpr uint32_t ADC_SCAN_RATE_TIMEOUT = 335;
+    static constexpr uint32_t RESET_SERVER_TIMEOUT = 86840;
+
     /**
      * Calls function 17 (0x11), ask for ILC identity.
      *
      * @param address ILC address
      */
-    void reportServerID(uint8_t address) { callFunction(address, 17, 835); }
+    void reportServerID(uint8_t address) { callFunction(address, 17, SERVER_ID_TIMEOUT); }
 
     /**
      * Calls function 18 (0x12), ask for ILC status.
      *
      * @param address ILC address
      */
-    void reportServerStatus(uint8_t address) { callFunction(address, 18, 270); }
+    void reportServerStatus(uint8_t address) { callFunction(address, 18, SERVER_STATUS_TIMEOUT); }
 
     enum ILCMode { Standby = 0, Disabled = 1, Enabled = 2, FirmwareUpdate = 3, Fault = 4, ClearFaults = 5 };
 
@@ -138,6 +244,21 @@ public:
      */
     void changeILCMode(uint8_t address, uint16_t mode);
 
+    /**
+     * Broadcast ILC mode change. ILC command code 65 (0x41) sent to broadcast
+     * address, followed by broadcast counter and the new mode. Only ILC
+     * firmware supporting broadcast mode changes acts on the command, and no
+     * reply is sent - the transition shall be verified with
+     * reportServerStatus.
+     *
+     * @param mode new ILC mode - see changeILCMode
+     * @param address broadcast address. Defaults to 250 (all ILCs)
+     * @param delay delay in us (microseconds) for ILCs to change mode
+     *
+     * @see BusModeTransition
+     */
+    void broadcastILCMode(uint16_t mode, uint8_t address = 250, uint32_t delay = 335);
+
     /**
      * Set temporary ILC address. ILC must be address-less (attached to address
      * 255). Can be used only if one ILC on a bus failed to read its address
@@ -148,19 +269,158 @@ public:
      */
     void setTempILCAddress(uint8_t temporaryAddress) { callFunction(255, 72, 250, temporaryAddress); }
 
+    /**
+     * Broadcast freeze sensor values. ILC command code 68 (0x44). ILCs
+     * receiving the broadcast latch their sensor values, so readouts
+     * following the broadcast return values sampled at the same instant.
+     * Uses broadcast counter.
+     *
+     * @param address broadcast address (248 for force actuators, 249 for hardpoints)
+     * @param delay delay in us (microseconds) for ILCs to latch the values
+     */
+    void broadcastFreezeSensorValues(uint8_t address = 248, uint32_t delay = 450) {
+        broadcastFunction(address, 68, nextBroadcastCounter(), delay, NULL, 0);
+    }
+
+    /**
+     * Sets freeze cycle mode. In freeze cycle mode, startCycle writes freeze
+     * sensor values broadcast followed by delay, so all values read in the
+     * cycle refer to the same instant.
+     *
+     * @param freeze true to enable freeze cycle mode
+     * @param address broadcast address for the freeze command
+     * @param delay delay in us (microseconds) after the freeze command
+     *
+     * @see broadcastFreezeSensorValues
+     */
+    void setFreezeCycle(bool freeze, uint8_t address = 248, uint32_t delay = 450);
+
+    /**
+     * Starts bus cycle. Shall be called before readout commands of the cycle
+     * are written into the buffer. Writes freeze sensor values broadcast if
+     * freeze cycle mode is enabled.
+     *
+     * @see setFreezeCycle
+     */
+    void startCycle();
+
+    /**
+     * Set ADC scan rate. Calls function 80 (0x50). Supported by pneumatic
+     * and electromechanical ILCs. Scan rate confirmed by the ILC response is
+     * used to model sample latency.
+     *
+     * @param address ILC address
+     * @param rate scan rate code (0-15), see getADCSampleRate
+     *
+     * @throw std::out_of_range if rate code is out of range
+     *
+     * @see readoutDue
+     */
+    void setADCScanRate(uint8_t address, uint8_t rate);
+
+    /**
+     * Returns ADC sample rate for scan rate code.
+     *
+     * Code | Rate (Hz) | Code | Rate (Hz)
+     * ---- | --------- | ---- | ---------
+     * 0    | 30000     | 8    | 60
+     * 1    | 15000     | 9    | 50
+     * 2    | 7500      | 10   | 30
+     * 3    | 3750      | 11   | 25
+     * 4    | 2000      | 12   | 15
+     * 5    | 1000      | 13   | 10
+     * 6    | 500       | 14   | 5
+     * 7    | 100       | 15   | 2.5
+     *
+     * @param rate scan rate code
+     *
+     * @return sample rate in Hz
+     *
+     * @throw std::out_of_range if rate code is out of range
+     */
+    static float getADCSampleRate(uint8_t rate);
+
+    /**
+     * Returns time needed by ILC ADC to provide a new sample. That's ADC
+     * sample period for the scan rate confirmed by the ILC.
+     *
+     * @param address ILC address
+     *
+     * @return sample latency, 0 if scan rate of the ILC isn't known
+     */
+    std::chrono::nanoseconds getSampleLatency(uint8_t address);
+
+    /**
+     * Checks whether a new sample is available since the last readout of
+     * the ILC. If it is, records now as the last readout time. Should be
+     * used to schedule sensor readouts - ILC shall not be read before it
+     * acquires a new sample.
+     *
+     * @param address ILC address
+     * @param now current time
+     *
+     * @return true if readout of the ILC shall be scheduled
+     *
+     * @see PollScheduler::addRateGroup
+     */
+    bool readoutDue(uint8_t address, std::chrono::steady_clock::time_point now);
+
     /**
      * Reset ILC. Calls function 107 (0x6b).
      *
      * @param address ILC address
      */
-    void resetServer(uint8_t address) { callFunction(address, 107, 86840); }
+    void resetServer(uint8_t address) { callFunction(address, 107, RESET_SERVER_TIMEOUT); }
+
+    /**
+     * Returns last known ILC mode.
+     *
+     * @param address ILC address
+     *
+     * @return last mode reported by the ILC
+     *
+     * @throw std::out_of_range if mode of the ILC isn't known
+     */
+    uint8_t getLastMode(uint8_t address);
+
+    /**
+     * Firmware identity reported in ILC server ID.
+     */
+    struct FirmwareRevision {
+        std::string name;
+        uint8_t majorRev;
+        uint8_t minorRev;
+    };
+
+    /**
+     * Returns firmware name and revision from the last server ID (function
+     * 17) response.
+     *
+     * @param address ILC address
+     *
+     * @return last firmware identity reported by the ILC
+     *
+     * @throw std::out_of_range if server ID of the ILC wasn't received
+     */
+    const FirmwareRevision &getFirmwareRevision(uint8_t address);
+
+    /**
+     * Encodes byte as ILC FIFO write instruction. Doesn't update CRC.
+     *
+     * @param data byte to write
+     *
+     * @return FIFO instruction
+     */
+    static uint16_t encodeByte(uint8_t data) { return FIFO::TX_MASK | ((static_cast<uint16_t>(data)) << 1); }
 
 protected:
     uint16_t getByteInstruction(uint8_t data) override;
 
     uint8_t readInstructionByte() override;
 
-    uint8_t getLastMode(uint8_t address) { return _lastMode.at(address); }
+    uint32_t functionTimeout(uint8_t address, uint8_t function, uint32_t timeout) override;
+
+    void processResponseTimeout(uint8_t address, uint8_t function, uint32_t timeout) override;
 
     const char *getModeStr(uint8_t mode);
 
@@ -275,6 +535,14 @@ protected:
      */
     virtual void processResetServer(uint8_t address) = 0;
 
+    /**
+     * Callback for reply to ADC scan rate change.
+     *
+     * @param address ILC address
+     * @param rate new ADC scan rate code
+     */
+    virtual void processADCScanRate(uint8_t address, uint8_t rate) {}
+
     /**
      * Return counter for broadcast commands.
      *
@@ -290,7 +558,8 @@ protected:
     /**
      * Cache management function. Search for cached response. If none is
      * found, create entry in cache. Use cache entry for
-     * ModbusBuffer::checkRecording call.
+     * ModbusBuffer::checkRecording call. Either response hash, or full
+     * response is compared - see setFullCompare.
      *
      * Example code in test_ILC.cpp hopefully explain how to use the function.
      *
@@ -305,17 +574,101 @@ protected:
      */
     bool responseMatchCached(uint8_t address, uint8_t func);
 
+    /**
+     * Filters telemetry changes. If no deadband or publish intervals were
+     * set for the function, always returns true.
+     *
+     * @param address ILC address
+     * @param func function code
+     * @param values received values
+     * @param count number of values
+     *
+     * @return true if callback shall be called with the values
+     *
+     * @see setDeadband
+     * @see setPublishIntervals
+     */
+    bool filterChanges(uint8_t address, uint8_t func, const double *values, size_t count);
+
+    /**
+     * Register action to be run at the end of a bus cycle. Can be used to
+     * publish data aggregated from multiple responses.
+     *
+     * @param action action to run
+     *
+     * @see endOfCycle
+     */
+    void addEndOfCycleAction(std::function<void()> action) { _endOfCycleActions.push_back(action); }
+
 private:
     uint8_t _bus;
 
     uint8_t _broadcastCounter;
     unsigned int _timestampShift;
 
+    bool _freezeCycle;
+    uint8_t _freezeAddress;
+    uint32_t _freezeDelay;
+
     bool _alwaysTrigger;
-    std::map<uint8_t, std::map<uint8_t, std::vector<uint8_t>>> _cachedResponse;
 
-    // last know ILC mode
-    std::map<uint8_t, uint8_t> _lastMode;
+    // index of function in _cachedResponse, NOT_CACHED if function response wasn't yet cached
+    static constexpr uint8_t NOT_CACHED = 0xFF;
+    uint8_t _cachedIndex[256];
+    uint8_t _cachedFunctions;
+
+    // cached responses, indexed with cached function index * 256 + address
+    std::vector<std::vector<uint8_t>> _cachedResponse;
+    std::vector<uint64_t> _cachedHash;
+
+    // telemetry filters, indexed by function code
+    std::unique_ptr<ChangeFilter> _changeFilters[256];
+
+    ChangeFilter &_getChangeFilter(uint8_t func);
+
+    std::vector<std::function<void()>> _endOfCycleActions;
+
+    // last know ILC mode, UNKNOWN_MODE if mode wasn't yet received
+    static constexpr uint8_t UNKNOWN_MODE = 0xFF;
+    uint8_t _lastMode[256];
+
+    // firmware identities from server ID responses
+    std::map<uint8_t, FirmwareRevision> _firmwareRevisions;
+
+    // ADC scan rate confirmed by ILC, UNKNOWN_RATE if not known
+    static constexpr uint8_t UNKNOWN_RATE = 0xFF;
+    uint8_t _adcScanRate[256];
+
+    // last readout time, time_point::min() if never read
+    std::chrono::steady_clock::time_point _lastReadout[256];
+
+    // learned timeouts configuration
+    bool _learnTimeouts;
+    uint32_t _timeoutFloor;
+    uint32_t _timeoutCeiling;
+    float _timeoutPercentile;
+    uint32_t _timeoutMargin;
+
+    // ring buffer of last response times (us)
+    struct ResponseTimes {
+        static constexpr size_t SIZE = 32;
+        uint32_t times[SIZE];
+        size_t count = 0;
+        size_t next = 0;
+        // added to learned timeout after missed replies (us)
+        uint32_t widening = 0;
+        // number of missed replies
+        uint32_t timeouts = 0;
+    };
+
+    // response times, indexed by address << 40 | function << 32 | requested timeout
+    std::map<uint64_t, ResponseTimes> _responseTimes;
+
+    static uint64_t _responseKey(uint8_t address, uint8_t function, uint32_t timeout) {
+        return static_cast<uint64_t>(address) << 40 | static_cast<uint64_t>(function) << 32 | timeout;
+    }
+
+    uint32_t _learnedTimeout(const ResponseTimes &times, uint32_t timeout);
 };
 
 }  // namespace cRIO
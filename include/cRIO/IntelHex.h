@@ -24,7 +24,9 @@
 #define CRIO_INTELHEX_H_
 
 #include <istream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace LSST {
@@ -41,11 +43,6 @@ struct IntelRecordType {
     };
 };
 
-struct IntelHexLine {
-    uint16_t address;
-    std::vector<uint8_t> data;
-};
-
 class LoadError : public std::runtime_error {
 public:
     LoadError(size_t line, uint16_t address, const std::string &arg) : std::runtime_error(arg) {
@@ -53,6 +50,13 @@ public:
         _address = address;
     }
 
+    /**
+     * Returns line number (1 based) of the line causing the error.
+     */
+    size_t getLine() const { return _line; }
+
+    uint16_t getAddress() const { return _address; }
+
 private:
     uint16_t _address;
     size_t _line;
@@ -61,6 +65,12 @@ private:
 /**
  * Class to read and parse Intel hex file. Provides methods to faciliate
  * loading firmware into ILC.
+ *
+ * The whole file is read into memory and parsed in place. Record data are
+ * stored directly into firmware image covering ILC (16bit) address space;
+ * address ranges containing data are recorded. Only addresses below 0xFFFF
+ * are supported - data following non-zero extended linear address records
+ * are ignored.
  */
 class IntelHex {
 public:
@@ -76,6 +86,16 @@ public:
     void load(const std::string &fileName);
     void load(std::istream &inputStream);
 
+    /**
+     * Parse & load Intel Hex data from memory buffer.
+     *
+     * @param buffer hex file content
+     * @param length buffer length
+     *
+     * @throws LoadError on error
+     */
+    void load(const char *buffer, size_t length);
+
     /**
      * Returns data to be written into ILC. Only three bytes out of every four
      * are written, but full buffer, as assembled from hex file lines, is
@@ -86,17 +106,51 @@ public:
      */
     std::vector<uint8_t> getData(uint16_t &startAddress);
 
+    /**
+     * View of the firmware image. Points to IntelHex internal data, so is
+     * valid only until the next load call.
+     */
+    struct View {
+        // memory start address
+        uint16_t startAddress;
+        // image data, with gaps between records filled
+        const uint8_t *data;
+        // data length
+        size_t length;
+    };
+
+    /**
+     * Returns view of the data to be written into ILC, without copying. The
+     * view contains the same data as returned by getData.
+     *
+     * @return image view
+     */
+    View getView() const;
+
+    /**
+     * Returns address ranges ([start, end)) containing data from the hex
+     * file, ordered by address. Overlapping and adjacent ranges are merged.
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>> &getRanges() const { return _ranges; }
+
 private:
-    void _processLine(const char *line, IntelHexLine *hexLine, IntelRecordType::Types &recordType);
-    void _sortByAddress();
+    bool _processLine(const char *line, const char *end, bool &extensionData);
+    void _addRange(uint32_t start, uint32_t end);
 
-    std::vector<IntelHexLine> _hexData;
     size_t _lineNo;
 
     /**
-     * Contains firmware data.
+     * Firmware image, indexed by address. Sized to accommodate record
+     * starting at the last address. Bytes not covered by records are filled
+     * with gap pattern - 0x00 at every fourth address, 0xFF otherwise.
+     */
+    std::vector<uint8_t> _image;
+
+    /**
+     * Address ranges ([start, end)) of the image containing data. Kept
+     * ordered and merged while records are loaded.
      */
-    std::vector<uint8_t> _appData;
+    std::vector<std::pair<uint32_t, uint32_t>> _ranges;
 };
 
 }  // namespace cRIO
@@ -70,6 +70,7 @@ public:
     void clearCommanded() {
         clear();
         _commands.clear();
+        _telemetryRegisters.clear();
     }
 
     /**
@@ -100,6 +101,42 @@ public:
      */
     void readHoldingRegisters(uint16_t address, uint16_t count, uint8_t timeout = 100);
 
+    /**
+     * Reads holding register(s) into FPGA telemetry. MPU copies received
+     * register values into its telemetry memory (TELEMETRY_16 commands), so
+     * the values are available with other FPGA telemetry without readout of
+     * the MPU output FIFO. Use processTelemetry to decode values from
+     * received telemetry.
+     *
+     * @param address first register address
+     * @param count number of registers to read
+     * @param telemetryOffset offset (in bytes) of the first register value in MPU telemetry
+     * @param timeout timeout for register readout (in ms)
+     *
+     * @throw std::out_of_range if registers don't fit into MPU telemetry
+     */
+    void readHoldingRegistersTelemetry(uint16_t address, uint16_t count, uint8_t telemetryOffset,
+                                       uint8_t timeout = 100);
+
+    /**
+     * Returns length of telemetry data filled by commands in the buffer.
+     *
+     * @return telemetry length (in bytes)
+     */
+    size_t getTelemetryLength();
+
+    /**
+     * Decodes MPU telemetry. Fills register values read with
+     * readHoldingRegistersTelemetry, which can be then retrieved with
+     * getRegister.
+     *
+     * @param telemetry telemetry data, as received from FPGA
+     * @param length telemetry length (in bytes)
+     *
+     * @throw std::runtime_error if telemetry is too short
+     */
+    void processTelemetry(uint8_t *telemetry, size_t length);
+
     /**
      * Write single register.
      *
@@ -143,6 +180,9 @@ private:
     std::list<std::pair<uint16_t, uint16_t>> _presetRegister;
     std::list<std::pair<uint16_t, uint16_t>> _presetRegisters;
 
+    // telemetry offset -> register address
+    std::map<uint8_t, uint16_t> _telemetryRegisters;
+
     std::map<uint16_t, bool> _inputStatus;
     std::map<uint16_t, uint16_t> _registers;
 };
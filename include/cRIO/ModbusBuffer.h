@@ -104,6 +104,12 @@ const static uint16_t RX_MASK = 0x9200;
  * SAL calls with events with same contents; shall not be used for telemetry
  * data, where even non-changed value shall be propagated)..
  *
+ * When hash recording is enabled (see setHashRecording), only running 64bit
+ * FNV-1a hash of read data is kept. checkRecording(uint64_t&) then compares
+ * the hash, so the change detection doesn't need any recording buffer.
+ * Calling checkRecording overload not matching the recording mode throws
+ * std::runtime_error, so change detection cannot silently stop.
+ *
  * Functions throws std::runtime_error (or its subclass) on any error.
  */
 class ModbusBuffer {
@@ -206,7 +212,7 @@ public:
      * @endcode
      *
      * @tparam dt variable data type. Supported are uint8_t, uint16_t,
-     * uint32_t, uint64_t and int32_t and float.
+     * uint32_t, uint64_t, int8_t, int32_t and float.
      *
      * @return value of read response
      */
@@ -331,12 +337,25 @@ public:
     void setBuffer(uint16_t* buffer, size_t length);
 
     /**
-     * Checks that no more replies are expected.
+     * Checks that no more replies are expected. When missing replies are
+     * tolerated, calls processMissingResponse for all remaining commands.
      *
      * @throw std::runtime_error if commands to be processed are still expected
+     *
+     * @see setTolerateMissing
      */
     void checkCommandedEmpty();
 
+    /**
+     * Sets missing replies handling. By default, missing reply raises
+     * UnmatchedFunction. If missing replies are tolerated, commands without
+     * reply are passed to processMissingResponse and skipped. Can be used to
+     * probe for devices which might not be present on the bus.
+     *
+     * @param tolerate if true, missing replies are tolerated
+     */
+    void setTolerateMissing(bool tolerate) { _tolerateMissing = tolerate; }
+
     /**
      * Add response callbacks. Both function code and error response code shall
      * be specified.
@@ -445,6 +464,19 @@ public:
          */
         uint16_t get() { return _crcCounter; }
 
+        /**
+         * Returns CRC change caused by change of a single message byte. As
+         * CRC is linear, CRC of the changed message equals CRC of the
+         * original message xor returned value. Allows incremental CRC
+         * updates of messages with few changed bytes.
+         *
+         * @param change xor of original and new byte value
+         * @param trailing number of message bytes following the changed byte
+         *
+         * @return value to xor with original message CRC
+         */
+        static uint16_t delta(uint8_t change, size_t trailing);
+
     private:
         uint16_t _crcCounter;
     };
@@ -542,9 +574,9 @@ protected:
         _functionArguments(params...);
         writeCRC();
         writeEndOfFrame();
-        writeWaitForRx(timeout);
+        writeWaitForRx(functionTimeout(address, function, timeout));
 
-        pushCommanded(address, function);
+        pushCommanded(address, function, timeout);
     }
 
     /**
@@ -570,7 +602,8 @@ protected:
      * @param function ModBus function code; if check is performed for error response, must equal to called
      * function
      *
-     * @throw UnmatchedFunction on error
+     * @throw UnmatchedFunction on error. If missing replies are tolerated,
+     * only if the reply doesn't match any remaining command
      */
     void checkCommanded(uint8_t address, uint8_t function);
 
@@ -593,10 +626,97 @@ protected:
      * @param cached values to compare
      *
      * @return true if cached equal what was read (with recording enabled)
+     *
+     * @throw std::runtime_error if hash recording is enabled
+     *
+     * @see setHashRecording
      */
     bool checkRecording(std::vector<uint8_t>& cached);
 
-    void pushCommanded(uint8_t address, uint8_t function);
+    /**
+     * Check if hash of recorded values match cached (previous) hash. If
+     * change is detected, cached parameter is updated with the new hash.
+     * Recording of changes is stopped. Hash recording shall be enabled.
+     *
+     * @param cached hash of previous values. Use 0 for unknown value
+     *
+     * @return true if cached hash equal hash of data read (with recording enabled)
+     *
+     * @throw std::runtime_error if hash recording is disabled
+     *
+     * @see setHashRecording
+     */
+    bool checkRecording(uint64_t& cached);
+
+    /**
+     * Sets change recording mode.
+     *
+     * @param hashRecording if true, only hash of the recorded data is
+     * calculated. checkRecording(uint64_t&) shall then be used to check for
+     * changes. If false, all recorded data are stored, and
+     * checkRecording(std::vector<uint8_t>&) shall be used
+     */
+    void setHashRecording(bool hashRecording) { _hashRecording = hashRecording; }
+
+    bool getHashRecording() { return _hashRecording; }
+
+    /**
+     * Stores address and function of a call expecting reply.
+     *
+     * @param address ModBus address on subnet. Broadcast addresses are ignored
+     * @param function ModBus function
+     * @param timeout requested (default) function timeout in us (microseconds), 0 if not known
+     */
+    void pushCommanded(uint8_t address, uint8_t function, uint32_t timeout = 0);
+
+    /**
+     * Returns reply timeout used for function call. Allows subclasses to
+     * replace default function timeouts.
+     *
+     * @param address ModBus address on subnet
+     * @param function ModBus function to call
+     * @param timeout default function timeout in us (microseconds)
+     *
+     * @return timeout to use in us (microseconds)
+     */
+    virtual uint32_t functionTimeout(uint8_t address, uint8_t function, uint32_t timeout) { return timeout; }
+
+    /**
+     * Returns address and function of the last processed response. Function
+     * is the called function also for error responses.
+     *
+     * @return address and function pair
+     */
+    std::pair<uint8_t, uint8_t> getLastResponse() { return _lastResponse; }
+
+    /**
+     * Returns timeout requested for the call of the last processed response.
+     *
+     * @return requested (default) function timeout in us (microseconds), 0 if not known
+     */
+    uint32_t getLastResponseTimeout() { return _lastResponseTimeout; }
+
+    /**
+     * Called for commands without reply when missing replies are tolerated.
+     *
+     * @param address device address
+     * @param function called function
+     *
+     * @see setTolerateMissing
+     */
+    virtual void processMissingResponse(uint8_t address, uint8_t function) {}
+
+    /**
+     * Called for every command whose reply wasn't received - either skipped
+     * as missing, or remaining after all responses were processed.
+     *
+     * @param address device address
+     * @param function called function
+     * @param timeout requested (default) function timeout in us (microseconds), 0 if not known
+     *
+     * @see checkCommandedEmpty
+     */
+    virtual void processResponseTimeout(uint8_t address, uint8_t function, uint32_t timeout) {}
 
 private:
     std::vector<uint16_t> _buffer;
@@ -608,7 +728,18 @@ private:
 
     CRC _crc;
 
-    std::queue<std::pair<uint8_t, uint8_t>> _commanded;
+    struct Commanded {
+        uint8_t address;
+        uint8_t function;
+        uint32_t timeout;
+    };
+
+    std::queue<Commanded> _commanded;
+
+    bool _tolerateMissing = false;
+
+    std::pair<uint8_t, uint8_t> _lastResponse;
+    uint32_t _lastResponseTimeout = 0;
 
     void _functionArguments() {}
 
@@ -621,6 +752,9 @@ private:
     bool _recordChanges;
     std::vector<uint8_t> _records;
 
+    bool _hashRecording;
+    uint64_t _recordHash;
+
     std::map<uint8_t, std::function<void(uint8_t)>> _actions;
     std::map<uint8_t, std::pair<uint8_t, std::function<void(uint8_t, uint8_t)>>> _errorActions;
 };
@@ -632,6 +766,13 @@ inline int32_t ModbusBuffer::read() {
     return ntohl(db);
 }
 
+template <>
+inline int8_t ModbusBuffer::read() {
+    int8_t ret;
+    readBuffer(&ret, 1);
+    return ret;
+}
+
 template <>
 inline uint8_t ModbusBuffer::read() {
     uint8_t ret;
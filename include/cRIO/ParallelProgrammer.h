@@ -0,0 +1,152 @@
+/*
+ * Concurrent firmware programming of ILCs on multiple buses.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_ParallelProgrammer_h
+#define _cRIO_ParallelProgrammer_h
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cRIO/FPGA.h>
+#include <cRIO/IntelHex.h>
+#include <cRIO/PreparedFirmware.h>
+#include <cRIO/PrintILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Programs ILCs on multiple buses concurrently. One ILC per bus is
+ * programmed at a time; programming steps of ILCs on different buses are
+ * interleaved in multi-bus FPGA transactions. Failure of an ILC doesn't stop
+ * programming of the other ILCs - the next ILC on the bus is programmed.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * ParallelProgrammer programmer(fpga);
+ * programmer.add(&busA, 1);
+ * programmer.add(&busA, 2);
+ * programmer.add(&busB, 1);
+ * for (auto r : programmer.program(hex)) {
+ *     if (r.success == false) {
+ *         std::cerr << +r.ilc->getBus() << "/" << +r.address << ": " << r.error << std::endl;
+ *     }
+ * }
+ * @endcode
+ *
+ * @see PrintILC::startProgramming
+ */
+class ParallelProgrammer {
+public:
+    /**
+     * Programming result.
+     */
+    struct Result {
+        PrintILC* ilc;
+        uint8_t address;
+        bool success;
+        // true if ILC already ran the target firmware
+        bool skipped;
+        // error message if programming failed
+        std::string error;
+    };
+
+    /**
+     * Construct programmer.
+     *
+     * @param fpga FPGA used to communicate with ILCs
+     */
+    ParallelProgrammer(FPGA* fpga);
+
+    virtual ~ParallelProgrammer() {}
+
+    /**
+     * Adds ILC to program. ILCs on the same bus shall use the same PrintILC
+     * instance, and are programmed in the order they were added.
+     *
+     * @param ilc bus ILC
+     * @param address ILC address
+     */
+    void add(PrintILC* ilc, uint8_t address);
+
+    /**
+     * Program all added ILCs.
+     *
+     * @param hex firmware to load into ILCs
+     *
+     * @return programming results, in order ILCs were finished
+     */
+    std::vector<Result> program(IntelHex& hex);
+
+    /**
+     * Program all added ILCs with prepared firmware.
+     *
+     * @param firmware firmware to load into ILCs
+     *
+     * @return programming results, in order ILCs were finished
+     */
+    std::vector<Result> program(std::shared_ptr<const PreparedFirmware> firmware);
+
+protected:
+    /**
+     * Called after every programming step. Default implementation does
+     * nothing.
+     *
+     * @param ilc bus ILC
+     * @param address ILC address
+     * @param step name of the next programming step
+     * @param progress fraction (0-1) of firmware pages written
+     */
+    virtual void processProgress(PrintILC* ilc, uint8_t address, const char* step, float progress) {}
+
+    /**
+     * Called when ILC programming finishes. Default implementation does
+     * nothing.
+     *
+     * @param result programming result
+     */
+    virtual void processResult(const Result& result) {}
+
+private:
+    FPGA* _fpga;
+
+    struct Bus {
+        PrintILC* ilc;
+        std::list<uint8_t> addresses;
+        uint8_t address;
+        bool active;
+    };
+
+    std::vector<Bus> _buses;
+
+    void _finish(Bus& bus, bool success, std::string error, std::vector<Result>& results);
+    bool _startNext(Bus& bus, const std::shared_ptr<const PreparedFirmware>& firmware,
+                    std::vector<Result>& results);
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_ParallelProgrammer_h
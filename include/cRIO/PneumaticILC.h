@@ -0,0 +1,189 @@
+/*
+ * Pneumatic (force actuator) ILC functions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_PneumaticILC_h
+#define _cRIO_PneumaticILC_h
+
+#include <bitset>
+
+#include <cRIO/DataTypes.h>
+#include <cRIO/ILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Force actuators status and measured forces, indexed by force actuator
+ * index. Arrays are cache line aligned. Bits in reported are set by
+ * PneumaticILC as responses are decoded; the owner of the structure shall
+ * reset them after values are consumed.
+ */
+struct ForceStatusArrays {
+    alignas(64) uint8_t status[FA_COUNT];
+    alignas(64) float primaryForce[FA_COUNT];
+    alignas(64) float secondaryForce[FA_COUNT];
+    std::bitset<FA_COUNT> reported;
+};
+
+/**
+ * Class for communication with Pneumatic (force actuator) ILCs.
+ *
+ * Single axis actuators (SAA) are expected on addresses 1-16, double axis
+ * actuators (DAA) on addresses 17-48. Force actuator index (0 based, up to
+ * FA_COUNT) shall be assigned to addresses on the bus with
+ * setForceActuator(). Forces are passed in N, and are send to ILCs quantized
+ * to mN.
+ *
+ * Replies received from ILCs shall be processed with ILC::processResponse method.
+ */
+class PneumaticILC : public virtual ILC {
+public:
+    /**
+     * Populate responses for known ILC functions.
+     *
+     * @param bus ILC bus number (1..). Defaults to 1.
+     */
+    PneumaticILC(uint8_t bus = 1);
+
+    /**
+     * Number of single axis actuators slots in broadcast force demand.
+     */
+    static constexpr int SAA_SLOTS = 16;
+
+    /**
+     * Number of double axis actuators slots in broadcast force demand.
+     */
+    static constexpr int DAA_SLOTS = 32;
+
+    /**
+     * Reply timeout (us) of force demand and force status functions.
+     */
+    static constexpr uint32_t FORCE_TIMEOUT = 1800;
+
+    /**
+     * Assign force actuator index to ILC address.
+     *
+     * @param address ILC address (1-48)
+     * @param index force actuator index (0 based, less than FA_COUNT)
+     *
+     * @throw std::out_of_range if address or index is out of range
+     */
+    void setForceActuator(uint8_t address, int index);
+
+    /**
+     * Returns true if the address belongs to double axis actuator.
+     *
+     * @param address ILC address
+     *
+     * @return true for double axis actuator address
+     */
+    static bool isDAA(uint8_t address) { return address > SAA_SLOTS; }
+
+    /**
+     * Unicast force demand. ILC command code 75 (0x4b).
+     *
+     * @param address ILC address
+     * @param slewFlag true if mirror is slewing
+     * @param primary primary axis force demand (N)
+     * @param secondary secondary axis force demand (N). Ignored for single axis actuators
+     */
+    void setForceDemand(uint8_t address, bool slewFlag, float primary, float secondary = 0);
+
+    /**
+     * Unicast force and status request. ILC command code 76 (0x4c).
+     *
+     * @param address ILC address
+     */
+    void reportForceStatus(uint8_t address) { callFunction(address, 76, FORCE_TIMEOUT); }
+
+    /**
+     * Broadcast force demand to all force actuators on the bus. ILC command
+     * code 75 (0x4b) to broadcast address 248. Demands are encoded in a
+     * single pass over frame slots. Slots without assigned force actuator
+     * are filled with 0.
+     *
+     * @param slewFlag true if mirror is slewing
+     * @param primary primary axis demands (N), indexed by force actuator index
+     * @param secondary secondary axis demands (N), indexed by force actuator index
+     */
+    void broadcastForceDemand(bool slewFlag, const float primary[FA_COUNT], const float secondary[FA_COUNT]);
+
+    /**
+     * Sets arrays for bulk decoding of force and status responses. When set,
+     * responses from ILCs with assigned force actuator index are decoded
+     * directly into the arrays, and processForceStatus isn't called for
+     * them. Arrays can be shared by multiple PneumaticILC instances (one for
+     * each bus).
+     *
+     * @param arrays caller owned arrays, nullptr to disable bulk decoding
+     */
+    void setForceStatusArrays(ForceStatusArrays *arrays) { _forceStatusArrays = arrays; }
+
+protected:
+    /**
+     * Called when response from call to command 75 (0x4b) or 76 (0x4c) is
+     * read. Fields for change filtering (see ILC::setDeadband) are status
+     * (0), primary force (1) and secondary force (2).
+     *
+     * @param address returned from this ILC
+     * @param status force actuator status
+     * @param primaryLoadCellForce primary axis measured force (N)
+     * @param secondaryLoadCellForce secondary axis measured force (N). NaN for single axis actuators
+     */
+    virtual void processForceStatus(uint8_t address, uint8_t status, float primaryLoadCellForce,
+                                    float secondaryLoadCellForce) = 0;
+
+    /**
+     * Called at the end of bus cycle if force statuses of all force
+     * actuators assigned to the bus were decoded into ForceStatusArrays
+     * during the cycle.
+     *
+     * @see setForceStatusArrays
+     */
+    virtual void processForceStatusArrays() {}
+
+    /**
+     * Returns force actuator index assigned to the address.
+     *
+     * @param address ILC address
+     *
+     * @return force actuator index, -1 if no actuator is assigned to the address
+     */
+    int getForceActuator(uint8_t address) { return _faIndex[address]; }
+
+private:
+    // force actuator indices, indexed by ILC address
+    int _faIndex[256];
+
+    ForceStatusArrays *_forceStatusArrays;
+
+    // actuators assigned to the bus, and actuators reported in the current cycle
+    std::bitset<FA_COUNT> _expected;
+    std::bitset<FA_COUNT> _reported;
+
+    void _writeForce(float force);
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_PneumaticILC_h
@@ -0,0 +1,151 @@
+/*
+ * Rate group scheduler of ILC polls.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_PollScheduler_h
+#define _cRIO_PollScheduler_h
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include <cRIO/ILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Schedules ILC polls into bus cycles. Polls are organized in rate groups -
+ * each group polls its addresses with the group rate. Polls of groups with
+ * rate lower than the cycle rate are spread over cycles, so every cycle
+ * contains about the same number of polls. In every cycle, polls of groups
+ * with higher rates are written first, followed by on-demand polls. Polls of
+ * sensor readout groups are skipped while the ILC ADC hasn't acquired a new
+ * sample, see ILC::readoutDue. ILC::startCycle (writing freeze sensor values
+ * broadcast in freeze cycle mode) is called only for ILCs with sensor
+ * readouts in the cycle, so cycles with only housekeeping polls don't spend
+ * bus time on the freeze broadcast.
+ *
+ * Example usage:
+ *
+ * @code{.cpp}
+ * PollScheduler scheduler(50);
+ * scheduler.addRateGroup(&ilc, 50, {1, 2, 3}, [&ilc](uint8_t a) { ilc.reportForceStatus(a); });
+ * scheduler.addRateGroup(&ilc, 1, {1, 2, 3}, [&ilc](uint8_t a) { ilc.reportServerStatus(a); });
+ *
+ * while (running) {
+ *     fpga.ilcCommands(scheduler.cycle());
+ * }
+ * @endcode
+ */
+class PollScheduler {
+public:
+    /**
+     * Function writing poll into ILC buffer.
+     */
+    typedef std::function<void(uint8_t)> PollFunction;
+
+    /**
+     * Construct scheduler.
+     *
+     * @param cycleRate rate (Hz) at which cycle() is called
+     */
+    PollScheduler(float cycleRate);
+
+    /**
+     * Adds rate group. Group rate is rounded to the nearest integer fraction
+     * of the cycle rate.
+     *
+     * @param ilc ILC into which buffer the polls are written
+     * @param rate group rate (Hz)
+     * @param addresses polled addresses
+     * @param poll function writing poll for the address into ILC buffer
+     * @param sensorReadout if true, polls read ADC samples. Scheduled poll is
+     * skipped if ILC doesn't have a new sample since the last readout (see
+     * ILC::readoutDue) and retried in the following cycles until the sample
+     * is ready. The first sensor readout of the ILC in a cycle is preceded by
+     * ILC::startCycle
+     *
+     * @throw std::out_of_range if rate isn't positive or is above the cycle rate
+     */
+    void addRateGroup(ILC* ilc, float rate, const std::vector<uint8_t>& addresses, PollFunction poll,
+                      bool sensorReadout = false);
+
+    /**
+     * Requests poll in the next cycle.
+     *
+     * @param ilc ILC into which buffer the poll is written
+     * @param address polled address
+     * @param poll function writing poll for the address into ILC buffer
+     */
+    void pollOnDemand(ILC* ilc, uint8_t address, PollFunction poll);
+
+    /**
+     * Assembles next cycle. Buffers of ILCs with polls in the cycle are
+     * cleared and polls are written into the buffers. ILC::startCycle is
+     * called before the first sensor readout poll of the ILC.
+     *
+     * @param now cycle time, used to decide on sensor readouts
+     *
+     * @return ILCs with polls in the cycle. Can be passed to FPGA::ilcCommands
+     */
+    std::vector<ILC*> cycle(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    /**
+     * Returns number of cycles assembled.
+     */
+    uint64_t getCycle() { return _cycle; }
+
+private:
+    struct RateGroup {
+        ILC* ilc;
+        float rate;
+        unsigned int divider;
+        std::vector<uint8_t> addresses;
+        // cycle phase (cycle % divider) of address polls
+        std::vector<unsigned int> phases;
+        // skipped sensor readouts, retried in the next cycle
+        std::vector<bool> retry;
+        PollFunction poll;
+        bool sensorReadout;
+    };
+
+    struct OnDemand {
+        ILC* ilc;
+        uint8_t address;
+        PollFunction poll;
+    };
+
+    float _cycleRate;
+    uint64_t _cycle;
+
+    // rate groups, ordered by rate (highest first)
+    std::vector<RateGroup> _groups;
+
+    std::vector<OnDemand> _onDemand;
+
+    void _schedule();
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_PollScheduler_h
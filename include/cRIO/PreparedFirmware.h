@@ -0,0 +1,109 @@
+/*
+ * Firmware prepared for ILC programming.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _cRIO_PreparedFirmware_h
+#define _cRIO_PreparedFirmware_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cRIO/IntelHex.h>
+
+namespace LSST {
+namespace cRIO {
+
+/**
+ * Firmware image prepared for programming into ILCs. Application data are
+ * read from Intel Hex, padded to 256 bytes pages, shrunk (every fourth byte
+ * is skipped) and encoded as ILC FIFO write instructions of Write
+ * Application Page (function 102) frames. Frames are encoded for address 0;
+ * when a frame is written for an ILC, only the address and frame CRC are
+ * patched. Application stats (data CRC, start address and length) are
+ * calculated as well.
+ *
+ * The same prepared firmware can be shared by any number of ILCs.
+ *
+ * @see PrintILC::startProgramming
+ */
+class PreparedFirmware {
+public:
+    /**
+     * Encoded page frame length - address, function, start address, length,
+     * 192 bytes of page data and CRC.
+     */
+    static constexpr size_t PAGE_FRAME_LENGTH = 1 + 1 + 2 + 2 + 192 + 2;
+
+    /**
+     * Prepares firmware.
+     *
+     * @param hex Intel Hex with ILC application
+     */
+    explicit PreparedFirmware(IntelHex& hex);
+
+    /**
+     * Returns application data CRC. CRC is calculated only from the data,
+     * skips filling.
+     */
+    uint16_t getDataCRC() const { return _dataCRC; }
+
+    /**
+     * Returns application start address.
+     */
+    uint16_t getStartAddress() const { return _startAddress; }
+
+    /**
+     * Returns application data length (unshrunk).
+     */
+    uint16_t getDataLength() const { return _dataLength; }
+
+    /**
+     * Returns number of application pages.
+     */
+    size_t getPageCount() const { return _frames.size() / PAGE_FRAME_LENGTH; }
+
+    /**
+     * Writes encoded page frame for an ILC.
+     *
+     * @param page page index
+     * @param address ILC address
+     * @param frame buffer for PAGE_FRAME_LENGTH FIFO instructions
+     */
+    void writePageFrame(size_t page, uint8_t address, uint16_t* frame) const;
+
+private:
+    uint16_t _dataCRC;
+    uint16_t _startAddress;
+    uint16_t _dataLength;
+
+    // encoded page frames for address 0
+    std::vector<uint16_t> _frames;
+    std::vector<uint16_t> _frameCRCs;
+
+    // frame CRC change caused by address change, indexed by address
+    uint16_t _addressCRCDelta[256];
+};
+
+}  // namespace cRIO
+}  // namespace LSST
+
+#endif  //! _cRIO_PreparedFirmware_h
@@ -23,8 +23,11 @@
 #ifndef _cRIO_PrintILC_
 #define _cRIO_PrintILC_
 
+#include <memory>
+
 #include <cRIO/ILC.h>
 #include <cRIO/FPGA.h>
+#include <cRIO/PreparedFirmware.h>
 
 namespace LSST {
 namespace cRIO {
@@ -79,9 +82,60 @@ public:
      */
     void writeVerifyApplication(uint8_t address) { callFunction(address, 103, 500000); }
 
+    /**
+     * Sets number of firmware pages written in a single FPGA transaction.
+     * Pages are packed into the command buffer as long as the buffer fits
+     * into maxLength; page acknowledgements are matched when the transaction
+     * responses are processed.
+     *
+     * @param pages maximal number of pages per transaction. Defaults to 1
+     * @param maxLength maximal command buffer length (in 16bit words)
+     *
+     * @throw std::out_of_range if pages is 0, or single page doesn't fit into maxLength
+     */
+    void setPagesPerTransaction(size_t pages, size_t maxLength = 4096);
+
+    /**
+     * Sets firmware identity expected after programming. When set, ILC server
+     * ID is read before programming, and ILCs reporting the same firmware
+     * name and revision are not reprogrammed.
+     *
+     * @param name firmware name
+     * @param majorRev firmware major revision
+     * @param minorRev firmware minor revision
+     *
+     * @see setForceProgramming
+     */
+    void setTargetFirmware(const std::string &name, uint8_t majorRev, uint8_t minorRev);
+
+    /**
+     * Programs ILCs even if they already run the target firmware.
+     *
+     * @param force if true, ILCs are always programmed
+     *
+     * @see setTargetFirmware
+     */
+    void setForceProgramming(bool force) { _forceProgramming = force; }
+
+    /**
+     * Returns true if the last started programming was skipped, as the ILC
+     * already runs the target firmware.
+     */
+    bool isProgramSkipped() { return _programSkipped; }
+
+    /**
+     * Returns application data CRC, as written by writeApplicationStats.
+     * Valid after startProgramming call.
+     *
+     * @return application data CRC, 0 if programming wasn't started
+     */
+    uint16_t getProgramCRC() { return _firmware == nullptr ? 0 : _firmware->getDataCRC(); }
+
     /**
      * Programs ILC. Executes a sequence of commands as follow:
      *
+     * 0. if target firmware is set, read ILC server ID and finish if ILC
+     * already runs the target firmware
      * 1. put ILC into standby mode
      * 2. put ILC into firmware update mode
      * 3. clears ILC faults
@@ -102,9 +156,58 @@ public:
      * @param fpga FPGA object
      * @param address ILC address
      * @param hex Intel Hex file to load into ILC
+     *
+     * @see startProgramming
      */
     void programILC(FPGA *fpga, uint8_t address, IntelHex &hex);
 
+    /**
+     * Starts ILC programming. Prepares firmware data; commands of the
+     * programming steps are written with writeProgramStep. Allows multiple
+     * ILCs on different buses to be programmed concurrently.
+     *
+     * @param address ILC address
+     * @param hex Intel Hex file to load into ILC
+     *
+     * @see programILC
+     * @see ParallelProgrammer
+     */
+    void startProgramming(uint8_t address, IntelHex &hex);
+
+    /**
+     * Starts ILC programming with prepared firmware. The firmware can be
+     * shared by all programmed ILCs, so firmware data are processed only
+     * once.
+     *
+     * @param address ILC address
+     * @param firmware prepared firmware to load into ILC
+     */
+    void startProgramming(uint8_t address, std::shared_ptr<const PreparedFirmware> firmware);
+
+    /**
+     * Clears buffer and writes commands of the next programming step. The
+     * commands shall be send to the ILC, and their responses processed,
+     * before the next step is written.
+     *
+     * @return true if step commands were written, false if the programming
+     * is finished
+     *
+     * @throw std::runtime_error if the ILC cannot be programmed
+     */
+    bool writeProgramStep();
+
+    /**
+     * Returns name of the current programming step.
+     */
+    const char *getProgramStepName();
+
+    /**
+     * Returns programming progress.
+     *
+     * @return fraction (0-1) of firmware pages written
+     */
+    float getProgramProgress();
+
 protected:
     void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
                          uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
@@ -167,11 +270,37 @@ protected:
 private:
     int _printout;
     uint8_t _lastAddress;
-    ModbusBuffer::CRC _crc;
-    uint16_t _startAddress;
-    uint16_t _dataLength;
 
-    void _writeHex(FPGA *fpga, uint8_t address, IntelHex &hex);
+    enum ProgramStep {
+        ReadStatus,
+        CheckFirmware,
+        LeaveMode,
+        EnterFirmwareUpdate,
+        ClearUpdateFaults,
+        Erase,
+        WritePages,
+        WriteStats,
+        Verify,
+        EnterStandby,
+        ClearStandbyFaults,
+        EnterDisabled,
+        Done
+    };
+
+    bool _targetFirmwareSet;
+    FirmwareRevision _targetFirmware;
+    bool _forceProgramming;
+    bool _programSkipped;
+
+    size_t _pagesPerTransaction;
+    size_t _maxTransactionLength;
+
+    ProgramStep _programStep;
+    uint8_t _programAddress;
+    std::shared_ptr<const PreparedFirmware> _firmware;
+    size_t _programPage;
+
+    void _writePage();
 };
 
 }  // namespace cRIO
@@ -23,6 +23,9 @@
 #ifndef _cRIO_ThermalILC_h
 #define _cRIO_ThermalILC_h
 
+#include <bitset>
+#include <memory>
+
 #include <cRIO/ILC.h>
 
 namespace LSST {
@@ -33,6 +36,19 @@ namespace cRIO {
  */
 constexpr int NUM_TS_ILC = 96;
 
+/**
+ * Thermal status of all thermal ILCs. Arrays are cache line aligned, so
+ * values can be processed with vector instructions. Only values with valid
+ * bit set were received in the last cycle.
+ */
+struct ThermalStatusFrame {
+    alignas(64) uint8_t status[NUM_TS_ILC];
+    alignas(64) float differentialTemperature[NUM_TS_ILC];
+    alignas(64) uint8_t fanRPM[NUM_TS_ILC];
+    alignas(64) float absoluteTemperature[NUM_TS_ILC];
+    std::bitset<NUM_TS_ILC> valid;
+};
+
 /**
  * Class for communication with Thermal ILCs.
  *
@@ -66,16 +82,56 @@ public:
     void reportThermalStatus(uint8_t address) { callFunction(address, 89, 300); }
 
     /**
-     * Broadcast heater PWM and fan RPM. ILC command code 88 (0x58).
+     * Broadcast heater PWM and fan RPM. ILC command code 88 (0x58). Encoded
+     * broadcast frame is kept between calls, only changed values are
+     * re-encoded and CRC is updated incrementally. Broadcast with the same
+     * values as the last broadcast is skipped, unless demand refresh interval
+     * elapsed since the last broadcast.
      *
      * @param heaterPWM[NUM_TS_ILC]
      * @param fanRPM[NUM_TS_ILC]
+     *
+     * @return true if broadcast was written to the buffer, false if it was skipped
+     *
+     * @see setDemandRefreshInterval
+     */
+    bool broadcastThermalDemand(uint8_t heaterPWM[NUM_TS_ILC], uint8_t fanRPM[NUM_TS_ILC]);
+
+    /**
+     * Sets interval for repeating unchanged thermal demand broadcasts.
+     * Defaults to 0, which means broadcasts are always sent.
+     *
+     * @param refreshInterval unchanged demand is broadcasted after this interval elapses
+     */
+    void setDemandRefreshInterval(std::chrono::steady_clock::duration refreshInterval) {
+        _demandRefreshInterval = refreshInterval;
+    }
+
+    /**
+     * Sets frame mode. In frame mode, thermal status responses fill
+     * ThermalStatusFrame, which is passed to processThermalStatusFrame at the
+     * end of bus cycle. processThermalStatus isn't called for ILCs with
+     * assigned frame index.
+     *
+     * @param frameMode true to enable frame mode
+     *
+     * @see setFrameIndex
      */
-    void broadcastThermalDemand(uint8_t heaterPWM[NUM_TS_ILC], uint8_t fanRPM[NUM_TS_ILC]);
+    void setFrameMode(bool frameMode) { _frameMode = frameMode; }
+
+    /**
+     * Sets ILC index in ThermalStatusFrame. Defaults to address - 1.
+     *
+     * @param address ILC address
+     * @param index index in frame arrays (0 based), NUM_TS_ILC or higher to not include ILC in the frame
+     */
+    void setFrameIndex(uint8_t address, uint8_t index) { _frameIndex[address] = index; }
 
 protected:
     /**
-     * Called when response from call to command 89 (0x59) is read.
+     * Called when response from call to command 89 (0x59) is read. Fields for
+     * change filtering (see ILC::setDeadband) are status (0), differential
+     * temperature (1), fan RPM (2) and absolute temperature (3).
      *
      * @param address status returned from this ILC
      * @param status ILC status. See LTS-646 for details.
@@ -85,6 +141,38 @@ protected:
      */
     virtual void processThermalStatus(uint8_t address, uint8_t status, float differentialTemperature,
                                       uint8_t fanRPM, float absoluteTemperature) = 0;
+
+    /**
+     * Called at the end of bus cycle in frame mode, if any thermal status was
+     * received during the cycle.
+     *
+     * @param frame received thermal status
+     *
+     * @see setFrameMode
+     */
+    virtual void processThermalStatusFrame(const ThermalStatusFrame &frame) {}
+
+private:
+    bool _frameMode;
+    uint8_t _frameIndex[256];
+
+    struct FrameDeleter {
+        void operator()(ThermalStatusFrame *frame) { free(frame); }
+    };
+
+    // allocated with aligned_alloc, as C++14 new doesn't guarantee alignment
+    std::unique_ptr<ThermalStatusFrame, FrameDeleter> _frame;
+
+    // thermal demand broadcast - address, function, counter, heater PWM & fan RPM pairs
+    uint8_t _demandMessage[3 + NUM_TS_ILC * 2];
+    uint16_t _demandCRC;
+    // encoded _demandMessage followed by CRC
+    std::vector<uint16_t> _demandFrame;
+
+    std::chrono::steady_clock::duration _demandRefreshInterval;
+    std::chrono::steady_clock::time_point _lastDemandBroadcast;
+
+    void _patchDemand(size_t offset, uint8_t data);
 };
 
 }  // namespace cRIO
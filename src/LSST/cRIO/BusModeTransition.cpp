@@ -0,0 +1,186 @@
+/*
+ * Bus-wide ILC mode transitions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cRIO/BusModeTransition.h>
+
+using namespace LSST::cRIO;
+
+namespace {
+
+/**
+ * Retrieves last known ILC mode.
+ *
+ * @param ilc bus ILC
+ * @param address ILC address
+ * @param mode returned last known mode
+ *
+ * @return false if the ILC never reported its mode
+ */
+bool lastMode(ILC* ilc, uint8_t address, uint8_t& mode) {
+    try {
+        mode = ilc->getLastMode(address);
+        return true;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+}  // namespace
+
+BusModeTransition::BusModeTransition(FPGA* fpga) : _fpga(fpga) {}
+
+void BusModeTransition::addBus(ILC* ilc, std::vector<uint8_t> addresses, bool broadcast,
+                               uint8_t broadcastAddress) {
+    _buses.push_back(Bus{ilc, addresses, broadcast, broadcastAddress});
+}
+
+void BusModeTransition::transition(uint8_t mode, int maxSteps) {
+    _statistics = Statistics();
+
+    std::vector<ILC*> ilcs;
+    for (auto& bus : _buses) {
+        ilcs.push_back(bus.ilc);
+        bus.ilc->clear();
+        for (auto address : bus.addresses) {
+            bus.ilc->reportServerStatus(address);
+        }
+    }
+    _commands(ilcs);
+
+    for (int step = 0; step < maxSteps; step++) {
+        std::vector<ILC*> commanded;
+        // address -> step mode, for ILCs which shall be verified after broadcast
+        std::vector<std::map<uint8_t, uint8_t>> broadcasted(_buses.size());
+
+        for (size_t b = 0; b < _buses.size(); b++) {
+            Bus& bus = _buses[b];
+            bus.ilc->clear();
+
+            // ILCs which never replied are skipped, and reported as failed at the end
+            std::map<uint8_t, uint8_t> pending;
+            for (auto address : bus.addresses) {
+                uint8_t current;
+                if (lastMode(bus.ilc, address, current) && current != mode) {
+                    pending[address] = nextMode(current, mode);
+                }
+            }
+
+            if (pending.empty()) {
+                continue;
+            }
+
+            commanded.push_back(bus.ilc);
+
+            // broadcast can be used only if it moves all pending ILCs from the same mode, and ILCs
+            // already in the target mode are not affected
+            uint8_t current = bus.ilc->getLastMode(pending.begin()->first);
+            uint8_t next = pending.begin()->second;
+            bool sameStep = true;
+            for (auto address : bus.addresses) {
+                uint8_t m;
+                if (lastMode(bus.ilc, address, m)) {
+                    sameStep = sameStep && (m == current || (m == mode && mode == next));
+                }
+            }
+
+            if (bus.broadcast && sameStep) {
+                uint32_t delay = ILC::CHANGE_MODE_TIMEOUT;
+                if (current == ILC::FirmwareUpdate || next == ILC::FirmwareUpdate) {
+                    delay = ILC::FIRMWARE_UPDATE_MODE_TIMEOUT;
+                }
+                bus.ilc->broadcastILCMode(next, bus.broadcastAddress, delay);
+                _statistics.broadcasts++;
+                for (auto address : bus.addresses) {
+                    bus.ilc->reportServerStatus(address);
+                }
+                broadcasted[b] = pending;
+            } else {
+                for (auto p : pending) {
+                    bus.ilc->changeILCMode(p.first, p.second);
+                    _statistics.unicasts++;
+                }
+            }
+        }
+
+        if (commanded.empty()) {
+            break;
+        }
+
+        _commands(commanded);
+
+        // unicast fallback for ILCs which didn't act on the broadcast
+        commanded.clear();
+        for (size_t b = 0; b < _buses.size(); b++) {
+            Bus& bus = _buses[b];
+            bus.ilc->clear();
+            for (auto p : broadcasted[b]) {
+                if (bus.ilc->getLastMode(p.first) != p.second) {
+                    bus.ilc->changeILCMode(p.first, p.second);
+                    _statistics.unicasts++;
+                }
+            }
+            if (bus.ilc->getLength() > 0) {
+                commanded.push_back(bus.ilc);
+            }
+        }
+
+        if (!commanded.empty()) {
+            _commands(commanded);
+        }
+    }
+
+    std::string failed;
+    for (auto& bus : _buses) {
+        for (auto address : bus.addresses) {
+            uint8_t m;
+            if (lastMode(bus.ilc, address, m) == false) {
+                failed += fmt::format(" {}:{} (no reply)", bus.ilc->getBus(), address);
+            } else if (m != mode) {
+                failed += fmt::format(" {}:{}", bus.ilc->getBus(), address);
+            }
+        }
+    }
+    if (!failed.empty()) {
+        throw std::runtime_error(
+                fmt::format("ILCs didn't reach mode {} in {} steps:{}", mode, maxSteps, failed));
+    }
+}
+
+uint8_t BusModeTransition::nextMode(uint8_t current, uint8_t target) {
+    if (current == ILC::Fault && target != ILC::Fault) {
+        return ILC::ClearFaults;
+    }
+    if (current <= ILC::Enabled && target <= ILC::Enabled && current != target) {
+        return current < target ? current + 1 : current - 1;
+    }
+    return target;
+}
+
+void BusModeTransition::_commands(const std::vector<ILC*>& ilcs) {
+    _fpga->ilcCommands(ilcs);
+    _statistics.transactions++;
+}
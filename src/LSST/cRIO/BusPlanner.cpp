@@ -0,0 +1,116 @@
+/*
+ * Bus time budget planner.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cRIO/BusPlanner.h>
+#include <cRIO/ElectromechanicalPneumaticILC.h>
+#include <cRIO/ILC.h>
+#include <cRIO/PneumaticILC.h>
+
+using namespace LSST::cRIO;
+
+// bits transferred per byte - start bit, 8 data bits, stop bit
+constexpr uint64_t BITS_PER_BYTE = 10;
+
+// Modbus inter-frame gap, in bytes (3.5 characters)
+constexpr double FRAME_GAP = 3.5;
+
+BusPlanner::BusPlanner(uint32_t baudRate, std::chrono::nanoseconds budget)
+        : _baudRate(baudRate), _budget(budget) {
+    // generic ILC functions
+    setFunctionTiming(17, 4, 31, ILC::SERVER_ID_TIMEOUT);
+    setFunctionTiming(18, 4, 9, ILC::SERVER_STATUS_TIMEOUT);
+    setFunctionTiming(65, 6, 6, ILC::CHANGE_MODE_TIMEOUT);
+    setFunctionTiming(80, 5, 5, ILC::ADC_SCAN_RATE_TIMEOUT);
+    setFunctionTiming(107, 4, 4, ILC::RESET_SERVER_TIMEOUT);
+
+    // actuator ILC functions
+    setFunctionTiming(66, 5, 13, ElectromechanicalPneumaticILC::HARDPOINT_TIMEOUT);
+    setFunctionTiming(67, 4, 13, ElectromechanicalPneumaticILC::HARDPOINT_TIMEOUT);
+    // double axis actuator (worst case) - address, function, slew flag, two I24 forces and CRC. Reply
+    // contains status and two float forces
+    setFunctionTiming(75, 11, 13, PneumaticILC::FORCE_TIMEOUT);
+    setFunctionTiming(76, 4, 13, PneumaticILC::FORCE_TIMEOUT);
+    setFunctionTiming(119, 4, 20, ElectromechanicalPneumaticILC::HARDPOINT_TIMEOUT);
+    setFunctionTiming(122, 4, 12, ElectromechanicalPneumaticILC::HARDPOINT_TIMEOUT);
+}
+
+void BusPlanner::setFunctionTiming(uint8_t func, size_t requestLength, size_t replyLength, uint32_t timeout) {
+    _timings[func].requestLength = requestLength;
+    _timings[func].replyLength = replyLength;
+    _timings[func].timeout = timeout;
+    _timings[func].known = true;
+}
+
+std::chrono::nanoseconds BusPlanner::estimate(uint8_t func) {
+    const Timing& timing = _timings[func];
+    if (timing.known == false) {
+        throw std::out_of_range(fmt::format("Unknown timing of function {}", func));
+    }
+    double bytes = timing.requestLength + FRAME_GAP;
+    if (timing.replyLength > 0) {
+        bytes += timing.replyLength + FRAME_GAP;
+    }
+    return std::chrono::nanoseconds(static_cast<int64_t>(bytes * BITS_PER_BYTE * 1e9 / _baudRate)) +
+           std::chrono::microseconds(timing.timeout);
+}
+
+void BusPlanner::queue(int priority, uint8_t func, std::function<void()> call) {
+    auto callEstimate = estimate(func);
+    if (callEstimate > _budget) {
+        throw std::out_of_range(fmt::format("Function {} call doesn't fit into cycle budget", func));
+    }
+
+    auto pos = _queue.begin();
+    while (pos != _queue.end() && pos->priority >= priority) {
+        pos++;
+    }
+    _queue.insert(pos, Call{priority, callEstimate, call});
+}
+
+std::chrono::nanoseconds BusPlanner::planCycle() {
+    std::chrono::nanoseconds planned = std::chrono::nanoseconds::zero();
+
+    while (!_queue.empty() && planned + _queue.front().estimate <= _budget) {
+        planned += _queue.front().estimate;
+        _queue.front().call();
+        _queue.pop_front();
+        _statistics.admitted++;
+    }
+
+    _statistics.cycles++;
+    if (!_queue.empty()) {
+        _statistics.deferrals += _queue.size();
+        _statistics.deferredCycles++;
+    }
+    if (_queue.size() > _statistics.maxBacklog) {
+        _statistics.maxBacklog = _queue.size();
+    }
+    if (planned > _statistics.maxPlanned) {
+        _statistics.maxPlanned = planned;
+    }
+
+    return planned;
+}
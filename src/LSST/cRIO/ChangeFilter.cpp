@@ -0,0 +1,100 @@
+/*
+ * Telemetry change filter.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <cRIO/ChangeFilter.h>
+
+using namespace LSST::cRIO;
+
+ChangeFilter::ChangeFilter()
+        : _minInterval(std::chrono::steady_clock::duration::zero()),
+          _maxInterval(std::chrono::steady_clock::duration::zero()),
+          _count(0),
+          _lastPublished(256, time_point::min()) {}
+
+void ChangeFilter::setDeadband(size_t field, double deadband, bool relative) {
+    if (field >= _deadbands.size()) {
+        _deadbands.resize(field + 1);
+    }
+    _deadbands[field].deadband = deadband;
+    _deadbands[field].relative = relative;
+}
+
+void ChangeFilter::setPublishIntervals(std::chrono::steady_clock::duration minInterval,
+                                       std::chrono::steady_clock::duration maxInterval) {
+    _minInterval = minInterval;
+    _maxInterval = maxInterval;
+}
+
+bool ChangeFilter::changed(uint8_t address, const double* values, size_t count, time_point now) {
+    // number of values changed - reset history
+    if (count != _count) {
+        _count = count;
+        _lastValues.assign(256 * _count, 0);
+        std::fill(_lastPublished.begin(), _lastPublished.end(), time_point::min());
+    }
+
+    double* last = _lastValues.data() + address * _count;
+
+    auto publish = [&]() {
+        std::copy(values, values + count, last);
+        _lastPublished[address] = now;
+        return true;
+    };
+
+    if (_lastPublished[address] == time_point::min()) {
+        return publish();
+    }
+
+    auto elapsed = now - _lastPublished[address];
+
+    if (elapsed < _minInterval) {
+        return false;
+    }
+
+    if (_maxInterval > std::chrono::steady_clock::duration::zero() && elapsed >= _maxInterval) {
+        return publish();
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (std::isnan(values[i]) || std::isnan(last[i])) {
+            if (std::isnan(values[i]) != std::isnan(last[i])) {
+                return publish();
+            }
+            continue;
+        }
+        double deadband = 0;
+        if (i < _deadbands.size()) {
+            deadband = _deadbands[i].deadband;
+            if (_deadbands[i].relative) {
+                deadband *= fabs(last[i]);
+            }
+        }
+        if (fabs(values[i] - last[i]) > deadband) {
+            return publish();
+        }
+    }
+
+    return false;
+}
@@ -26,6 +26,9 @@
 namespace LSST {
 namespace cRIO {
 
+Command::Command(int priority)
+        : _priority(priority), _deadline(std::chrono::steady_clock::time_point::max()) {}
+
 Command::~Command() {}
 
 bool Command::validate() { return true; }
@@ -32,7 +32,8 @@ using namespace std::chrono_literals;
 namespace LSST {
 namespace cRIO {
 
-ControllerThread::ControllerThread(token) : _exitRequested(false) {
+ControllerThread::ControllerThread(token)
+        : _head(nullptr), _sleeping(false), _sequence(0), _exitRequested(false) {
     SPDLOG_DEBUG("ControllerThread: ControllerThread()");
 }
 
@@ -40,47 +41,92 @@ ControllerThread::~ControllerThread() { _clear(); }
 
 void ControllerThread::enqueue(Command* command) {
     SPDLOG_TRACE("ControllerThread: enqueue()");
-    {
-        std::lock_guard<std::mutex> lg(runMutex);
-        _queue.push(command);
+    command->_next = _head.load();
+    while (!_head.compare_exchange_weak(command->_next, command)) {
+    }
+
+    // controller thread checks the queue after announcing sleep, so when it
+    // doesn't sleep, it will see the command. Taking the lock guarantees the
+    // controller thread either sees the command or already waits for
+    // notification
+    if (_sleeping.load()) {
+        { std::lock_guard<std::mutex> lg(runMutex); }
+        runCondition.notify_one();
     }
-    runCondition.notify_one();
 }
 
 void ControllerThread::run(std::unique_lock<std::mutex>& lock) {
     SPDLOG_INFO("ControllerThread: Run");
-    // runs commands already queued
-    _runCommands();
-    while (keepRunning) {
-        runCondition.wait(lock);
+    while (true) {
+        // runs commands already queued, without lock held
+        lock.unlock();
         _runCommands();
+        lock.lock();
+
+        if (keepRunning == false) {
+            break;
+        }
+
+        _sleeping.store(true);
+        if (_head.load() == nullptr) {
+            runCondition.wait(lock);
+        }
+        _sleeping.store(false);
     }
     SPDLOG_INFO("ControllerThread: Completed");
 }
 
-// runMutex must be locked by calling method to guard _queue access!!
+Command* ControllerThread::_dequeueAll() {
+    // reverse LIFO stack to get commands in enqueue order
+    Command* stack = _head.exchange(nullptr);
+    Command* ret = nullptr;
+    while (stack != nullptr) {
+        Command* next = stack->_next;
+        stack->_next = ret;
+        ret = stack;
+        stack = next;
+    }
+    return ret;
+}
+
+void ControllerThread::_pull() {
+    Command* command = _dequeueAll();
+    while (command != nullptr) {
+        Command* next = command->_next;
+        _pending.push(Pending{command, command->getPriority(), _sequence++});
+        command = next;
+    }
+}
+
 void ControllerThread::_runCommands() {
-    while (!_queue.empty()) {
-        Command* command = _queue.front();
-        _queue.pop();
+    _pull();
+    while (!_pending.empty()) {
+        Command* command = _pending.top().command;
+        _pending.pop();
         _execute(command);
+        // commands enqueued during execution can have higher priority
+        _pull();
     }
 }
 
 void ControllerThread::_clear() {
     SPDLOG_TRACE("ControllerThread: _clear()");
-    {
-        std::lock_guard<std::mutex> lg(runMutex);
-        while (!_queue.empty()) {
-            Command* command = _queue.front();
-            _queue.pop();
-            delete command;
-        }
+    _pull();
+    while (!_pending.empty()) {
+        delete _pending.top().command;
+        _pending.pop();
     }
 }
 
 void ControllerThread::_execute(Command* command) {
     SPDLOG_TRACE("ControllerThread: _execute()");
+    if (command->isExpired(std::chrono::steady_clock::now())) {
+        SPDLOG_WARN("Command deadline expired, not executing");
+        command->ackFailed("Command deadline expired");
+        delete command;
+        return;
+    }
+
     try {
         command->ackInProgress();
         command->execute();
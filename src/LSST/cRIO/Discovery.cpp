@@ -0,0 +1,119 @@
+/*
+ * Discovery of ILCs present on buses.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <memory>
+
+#include <cRIO/Discovery.h>
+
+using namespace LSST::cRIO;
+
+namespace {
+
+/**
+ * ILC probing addresses with server ID requests. Missing replies are
+ * tolerated, received server IDs are stored.
+ */
+class DiscoveryILC : public ILC {
+public:
+    DiscoveryILC(uint8_t bus, std::vector<Discovery::ServerID>& found) : ILC(bus), _found(found) {
+        setTolerateMissing(true);
+        setAlwaysTrigger(true);
+    }
+
+    void probe(uint8_t address, uint32_t timeout) { callFunction(address, 17, timeout); }
+
+protected:
+    void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
+                         uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
+                         uint8_t minorRev, std::string firmwareName) override {
+        _found.push_back(Discovery::ServerID{getBus(), address, uniqueID, ilcAppType, networkNodeType,
+                                             ilcSelectedOptions, networkNodeOptions, majorRev, minorRev,
+                                             firmwareName});
+    }
+
+    void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override {}
+    void processChangeILCMode(uint8_t address, uint16_t mode) override {}
+    void processSetTempILCAddress(uint8_t address, uint8_t newAddress) override {}
+    void processResetServer(uint8_t address) override {}
+
+private:
+    std::vector<Discovery::ServerID>& _found;
+};
+
+}  // namespace
+
+Discovery::Discovery(FPGA* fpga, std::vector<uint8_t> buses)
+        : _fpga(fpga), _buses(buses), _batchSize(64), _replyTimeout(300) {}
+
+std::vector<Discovery::ServerID> Discovery::scan(uint8_t firstAddress, uint8_t lastAddress) {
+    std::vector<ServerID> found;
+    _errors.clear();
+
+    std::vector<std::unique_ptr<DiscoveryILC>> ilcs;
+    for (auto bus : _buses) {
+        ilcs.emplace_back(new DiscoveryILC(bus, found));
+    }
+
+    int address = firstAddress;
+    while (address <= lastAddress) {
+        int batchEnd = std::min(static_cast<int>(address + _batchSize - 1), static_cast<int>(lastAddress));
+        std::vector<ILC*> commanded;
+        for (auto& ilc : ilcs) {
+            // failed buses aren't scanned further
+            if (_errors.count(ilc->getBus()) > 0) {
+                continue;
+            }
+            ilc->clear();
+            for (int a = address; a <= batchEnd; a++) {
+                ilc->probe(a, _replyTimeout);
+            }
+            commanded.push_back(ilc.get());
+        }
+
+        if (commanded.empty()) {
+            break;
+        }
+
+        // missing replies are tolerated, so ILCs commanded without reply are skipped
+        std::map<ILC*, std::exception_ptr> errors;
+        _fpga->ilcCommands(commanded, 5000, &errors);
+
+        for (auto& error : errors) {
+            try {
+                std::rethrow_exception(error.second);
+            } catch (std::exception& e) {
+                _errors[error.first->getBus()] = e.what();
+            }
+        }
+
+        address = batchEnd + 1;
+    }
+
+    std::sort(found.begin(), found.end(), [](const ServerID& a, const ServerID& b) {
+        return a.bus == b.bus ? a.address < b.address : a.bus < b.bus;
+    });
+
+    return found;
+}
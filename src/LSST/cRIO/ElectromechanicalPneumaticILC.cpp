@@ -20,18 +20,34 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+
+#include <spdlog/fmt/fmt.h>
+
 #include <cRIO/ElectromechanicalPneumaticILC.h>
 
 namespace LSST {
 namespace cRIO {
 
 ElectromechanicalPneumaticILC::ElectromechanicalPneumaticILC(uint8_t bus) : ILC(bus) {
-    auto hardpointForceStatus = [this](uint8_t address) {
+    for (int address = 0; address < 256; address++) {
+        _hpIndex[address] = -1;
+    }
+    for (int i = 0; i < HP_COUNT; i++) {
+        _breakawayLVDT[i] = NAN;
+        _displacementLVDT[i] = NAN;
+    }
+
+    auto hardpointForceStatus = [this](uint8_t address, uint8_t func) {
         uint8_t status = read<uint8_t>();
         int32_t encoderPosition = read<int32_t>();
         float loadCellForce = read<float>();
         checkCRC();
-        processHardpointForceStatus(address, status, encoderPosition, loadCellForce);
+        double values[3] = {static_cast<double>(status), static_cast<double>(encoderPosition),
+                            loadCellForce};
+        if (filterChanges(address, func, values, 3)) {
+            processHardpointForceStatus(address, status, encoderPosition, loadCellForce);
+        }
     };
 
     auto calibrationData = [this](uint8_t address) {
@@ -60,10 +76,33 @@ ElectromechanicalPneumaticILC::ElectromechanicalPneumaticILC(uint8_t bus) : ILC(
         secondaryPull = read<float>();
         secondaryPush = read<float>();
         checkCRC();
-        processMezzaninePressure(address, primaryPush, primaryPull, secondaryPush, secondaryPull);
+        double values[4] = {primaryPush, primaryPull, secondaryPush, secondaryPull};
+        if (filterChanges(address, 119, values, 4)) {
+            processMezzaninePressure(address, primaryPush, primaryPull, secondaryPush, secondaryPull);
+        }
+    };
+
+    auto lvdtData = [this](uint8_t address) {
+        float breakawayLVDT = read<float>();
+        float displacementLVDT = read<float>();
+        checkCRC();
+        int index = _hpIndex[address];
+        if (index >= 0) {
+            _breakawayLVDT[index] = breakawayLVDT;
+            _displacementLVDT[index] = displacementLVDT;
+            _lvdtReported.set(index);
+        }
+        double values[2] = {breakawayLVDT, displacementLVDT};
+        if (filterChanges(address, 122, values, 2)) {
+            processHardpointLVDT(address, breakawayLVDT, displacementLVDT);
+        }
     };
 
-    addResponse(67, hardpointForceStatus, 200);
+    addResponse(
+            66, [hardpointForceStatus](uint8_t address) { hardpointForceStatus(address, 66); }, 194);
+
+    addResponse(
+            67, [hardpointForceStatus](uint8_t address) { hardpointForceStatus(address, 67); }, 200);
 
     addResponse(
             81, [this](uint8_t address) { checkCRC(); }, 235);
@@ -71,6 +110,42 @@ ElectromechanicalPneumaticILC::ElectromechanicalPneumaticILC(uint8_t bus) : ILC(
     addResponse(110, calibrationData, 238);
 
     addResponse(119, pressureData, 247);
+
+    addResponse(122, lvdtData, 250);
+
+    addEndOfCycleAction([this]() {
+        if (_lvdtReported.none()) {
+            return;
+        }
+        processHardpointLVDTs(_breakawayLVDT, _displacementLVDT);
+        for (int i = 0; i < HP_COUNT; i++) {
+            _breakawayLVDT[i] = NAN;
+            _displacementLVDT[i] = NAN;
+        }
+        _lvdtReported.reset();
+    });
+}
+
+void ElectromechanicalPneumaticILC::setHardpoint(uint8_t address, int index) {
+    if (address == 0 || address > 247) {
+        throw std::out_of_range(fmt::format("Invalid hardpoint ILC address: {}", address));
+    }
+    if (index < 0 || index >= HP_COUNT) {
+        throw std::out_of_range(fmt::format("Invalid hardpoint index: {}", index));
+    }
+    _hpIndex[address] = index;
+}
+
+void ElectromechanicalPneumaticILC::broadcastStepperSteps(const int8_t steps[HP_COUNT]) {
+    write<uint8_t>(249);
+    write<uint8_t>(66);
+    write(nextBroadcastCounter());
+    for (int i = 0; i < HP_COUNT; i++) {
+        write<int8_t>(steps[i]);
+    }
+    writeCRC();
+    writeEndOfFrame();
+    writeDelay(150);
 }
 
 }  // namespace cRIO
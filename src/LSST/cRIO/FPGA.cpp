@@ -21,6 +21,8 @@
  */
 
 #include <chrono>
+#include <list>
+#include <map>
 #include <string.h>
 #include <thread>
 
@@ -47,11 +49,73 @@ FPGA::FPGA(fpgaType type) {
 }
 
 void FPGA::ilcCommands(ILC &ilc) {
-    size_t requestLen = ilc.getLength();
-    if (requestLen == 0) {
+    if (ilc.getLength() == 0) {
         return;
     }
-    requestLen += 6;
+
+    _writeILCCommands(ilc);
+
+    std::this_thread::sleep_for(1ms);
+
+    uint32_t irq = getIrq(ilc.getBus());
+
+    waitOnIrqs(irq, 5000);
+    ackIrqs(irq);
+
+    _readILCResponses(ilc);
+}
+
+void FPGA::ilcCommands(std::vector<ILC *> ilcs, uint32_t timeout,
+                       std::map<ILC *, std::exception_ptr> *errors) {
+    uint32_t usedBuses = 0;
+    std::vector<ILC *> commanded;
+    for (auto ilc : ilcs) {
+        uint32_t busBit = 1 << ilc->getBus();
+        if (usedBuses & busBit) {
+            throw std::runtime_error(fmt::format("FPGA::ilcCommands bus {} used twice", ilc->getBus()));
+        }
+        usedBuses |= busBit;
+        if (ilc->getLength() > 0) {
+            commanded.push_back(ilc);
+        }
+    }
+
+    if (commanded.empty()) {
+        return;
+    }
+
+    for (auto ilc : commanded) {
+        _writeILCCommands(*ilc);
+    }
+
+    std::this_thread::sleep_for(1ms);
+
+    for (auto ilc : commanded) {
+        uint32_t irq = getIrq(ilc->getBus());
+        waitOnIrqs(irq, timeout);
+        ackIrqs(irq);
+    }
+
+    std::exception_ptr first;
+    for (auto ilc : commanded) {
+        try {
+            _readILCResponses(*ilc);
+        } catch (...) {
+            if (errors != NULL) {
+                (*errors)[ilc] = std::current_exception();
+            } else if (!first) {
+                first = std::current_exception();
+            }
+        }
+    }
+
+    if (first) {
+        std::rethrow_exception(first);
+    }
+}
+
+void FPGA::_writeILCCommands(ILC &ilc) {
+    size_t requestLen = ilc.getLength() + 6;
 
     uint16_t data[requestLen];
 
@@ -66,16 +130,11 @@ void FPGA::ilcCommands(ILC &ilc) {
     data[requestLen - 1] = _modbusSoftwareTrigger;
 
     writeCommandFIFO(data, requestLen, 0);
+}
 
-    std::this_thread::sleep_for(1ms);
-
-    uint32_t irq = getIrq(bus);
-
-    waitOnIrqs(irq, 5000);
-    ackIrqs(irq);
-
+void FPGA::_readILCResponses(ILC &ilc) {
     // get back response
-    writeRequestFIFO(getRxCommand(bus), 0);
+    writeRequestFIFO(getRxCommand(ilc.getBus()), 0);
 
     uint16_t responseLen;
 
@@ -102,6 +161,8 @@ void FPGA::ilcCommands(ILC &ilc) {
     int endTsShift = 0;
 
     uint16_t *dataStart = NULL;
+    // true when reply was processed, but its end timestamp wasn't yet fully received
+    bool replyPending = false;
     for (uint16_t *p = buffer + 4; p < buffer + responseLen; p++) {
         switch (*p & 0xF000) {
             // data..
@@ -115,24 +176,40 @@ void FPGA::ilcCommands(ILC &ilc) {
                     throw std::runtime_error("End timestamp received twice!");
                 }
 
-                endTs |= static_cast<uint64_t>((*p) & 0x00FF) << endTsShift;
-                endTsShift += 8;
-                // don't break here - data also ends when timestamp is received
-            case FIFO::RX_ENDFRAME:
+                // data also ends when timestamp is received
                 if (dataStart) {
                     ilc.processResponse(dataStart, p - dataStart);
                     dataStart = NULL;
+                    replyPending = true;
+                }
+
+                endTs |= static_cast<uint64_t>((*p) & 0x00FF) << endTsShift;
+                endTsShift += 8;
+
+                // reply time is known after full timestamp is received
+                if (endTsShift == 64 && replyPending) {
+                    ilc.reportResponseTime(beginTs, endTs);
+                    replyPending = false;
                     reportTime(beginTs, endTs);
                     beginTs = endTs;
                     endTs = 0;
                     endTsShift = 0;
                 }
                 break;
+            case FIFO::RX_ENDFRAME:
+                if (dataStart) {
+                    ilc.processResponse(dataStart, p - dataStart);
+                    dataStart = NULL;
+                    replyPending = true;
+                }
+                break;
             default:
                 throw std::runtime_error(fmt::format("Invalid reply: {0:04x} ({0})", *p));
         }
     }
 
+    ilc.endOfCycle();
+
     ilc.checkCommandedEmpty();
 
     reportTime(beginTs, endTs);
@@ -147,5 +224,41 @@ void FPGA::mpuCommands(MPU &mpu) {
     }
 }
 
+void FPGA::mpuCommands(std::vector<MPU *> mpus) {
+    std::map<uint8_t, std::list<MPU *>> busQueues;
+    for (auto mpu : mpus) {
+        busQueues[mpu->getBus()].push_back(mpu);
+    }
+
+    // each round commands single MPU from every bus
+    while (!busQueues.empty()) {
+        std::vector<MPU *> round;
+        for (auto it = busQueues.begin(); it != busQueues.end();) {
+            round.push_back(it->second.front());
+            it->second.pop_front();
+            if (it->second.empty()) {
+                it = busQueues.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        bool containsRead = false;
+        for (auto mpu : round) {
+            writeMPUFIFO(*mpu);
+            containsRead |= mpu->containsRead();
+        }
+
+        if (containsRead) {
+            std::this_thread::sleep_for(500ms);
+            for (auto mpu : round) {
+                if (mpu->containsRead()) {
+                    readMPUFIFO(*mpu);
+                }
+            }
+        }
+    }
+}
+
 }  // namespace cRIO
 }  // namespace LSST
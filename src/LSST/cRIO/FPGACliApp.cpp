@@ -21,21 +21,61 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <map>
 
 #include "cRIO/FPGACliApp.h"
 #include "cRIO/IntelHex.h"
+#include "cRIO/ParallelProgrammer.h"
 
 using namespace LSST::cRIO;
 
+namespace {
+
+/**
+ * Prints programming steps of ILCs.
+ */
+class CliProgrammer : public ParallelProgrammer {
+public:
+    CliProgrammer(FPGA* fpga) : ParallelProgrammer(fpga) {}
+
+protected:
+    void processProgress(PrintILC* ilc, uint8_t address, const char* step, float progress) override {
+        const char*& last = _steps[std::make_pair(ilc, address)];
+        if (last != nullptr && strcmp(last, step) == 0) {
+            return;
+        }
+        // terminates line of dots printed for written pages
+        if (last != nullptr && strcmp(last, "writing pages") == 0) {
+            std::cout << std::endl;
+        }
+        std::cout << "ILC " << static_cast<int>(ilc->getBus()) << "/" << static_cast<int>(address) << ": "
+                  << step << std::endl;
+        last = step;
+    }
+
+private:
+    std::map<std::pair<PrintILC*, uint8_t>, const char*> _steps;
+};
+
+}  // namespace
+
 std::ostream& LSST::cRIO::operator<<(std::ostream& stream, ILCUnit const& u) {
     stream << static_cast<int>(u.first->getBus()) << "/" << static_cast<int>(u.second);
     return stream;
 }
 
 FPGACliApp::FPGACliApp(const char* name, const char* description)
-        : CliApp(name, description), _fpga(nullptr), _ilcs(), _autoOpen(true), _timeIt(false) {
+        : CliApp(name, description),
+          _fpga(nullptr),
+          _ilcs(),
+          _autoOpen(true),
+          _timeIt(false),
+          _programPages(1),
+          _programTargetSet(false),
+          _programForce(false) {
     addArgument('d', "increase debug level");
     addArgument('h', "print this help");
     addArgument('O', "don't auto open (and run) FPGA");
@@ -70,6 +110,13 @@ FPGACliApp::FPGACliApp(const char* name, const char* description)
 
     addCommand("program-ilc", std::bind(&FPGACliApp::programILC, this, std::placeholders::_1), "FS?",
                NEED_FPGA, "<firmware hex file> <ILC...>", "Program ILC with new firmware.");
+    addCommand("@program-pages", std::bind(&FPGACliApp::programPages, this, std::placeholders::_1), "i", 0,
+               "[pages]", "Report/set number of firmware pages written in a single transaction");
+    addCommand("@program-target", std::bind(&FPGACliApp::programTarget, this, std::placeholders::_1), "sii",
+               0, "[<name> <major> <minor>]",
+               "Report/set firmware identity. ILCs already running it aren't programmed");
+    addCommand("@program-force", std::bind(&FPGACliApp::programForce, this, std::placeholders::_1), "b", 0,
+               "[flag]", "Program ILCs even if they run target firmware");
     addCommand("help", std::bind(&FPGACliApp::helpCommands, this, std::placeholders::_1), "", 0, NULL,
                "Print commands help");
     addCommand("open", std::bind(&FPGACliApp::openFPGA, this, std::placeholders::_1), "", 0, NULL,
@@ -110,6 +157,53 @@ int FPGACliApp::timeit(command_vec cmds) {
     return 0;
 }
 
+int FPGACliApp::programPages(command_vec cmds) {
+    if (cmds.size() == 1) {
+        int pages = std::stoi(cmds[0]);
+        if (pages < 1) {
+            std::cerr << "Invalid number of pages: " << pages << std::endl;
+            return -1;
+        }
+        _programPages = pages;
+    }
+    std::cout << "Pages per transaction: " << _programPages << std::endl;
+    return 0;
+}
+
+int FPGACliApp::programTarget(command_vec cmds) {
+    switch (cmds.size()) {
+        case 0:
+            break;
+        case 3:
+            _programTarget = ILC::FirmwareRevision{cmds[0], static_cast<uint8_t>(std::stoi(cmds[1])),
+                                                   static_cast<uint8_t>(std::stoi(cmds[2]))};
+            _programTargetSet = true;
+            break;
+        default:
+            std::cerr << "Expecting firmware name, major and minor revision" << std::endl;
+            return -1;
+    }
+    if (_programTargetSet) {
+        std::cout << "Target firmware: " << _programTarget.name << " " << +_programTarget.majorRev << "."
+                  << +_programTarget.minorRev << std::endl;
+    } else {
+        std::cout << "Target firmware not set." << std::endl;
+    }
+    return 0;
+}
+
+int FPGACliApp::programForce(command_vec cmds) {
+    if (cmds.size() == 1) {
+        _programForce = onOff(cmds[0]);
+    }
+    if (_programForce) {
+        std::cout << "Will program ILCs running target firmware." << std::endl;
+    } else {
+        std::cout << "ILCs running target firmware will not be programmed." << std::endl;
+    }
+    return 0;
+}
+
 int FPGACliApp::closeFPGA(command_vec cmds) {
     _fpga->close();
     delete _fpga;
@@ -128,11 +222,31 @@ int FPGACliApp::programILC(command_vec cmds) {
         return -1;
     }
 
+    CliProgrammer programmer(getFPGA());
     for (auto u : units) {
-        u.first->programILC(getFPGA(), u.second, hf);
+        u.first->setPagesPerTransaction(_programPages);
+        if (_programTargetSet) {
+            u.first->setTargetFirmware(_programTarget.name, _programTarget.majorRev,
+                                       _programTarget.minorRev);
+        }
+        u.first->setForceProgramming(_programForce);
+        programmer.add(u.first.get(), u.second);
     }
 
-    return 0;
+    int ret = 0;
+    for (auto r : programmer.program(hf)) {
+        if (r.skipped) {
+            std::cout << "ILC " << static_cast<int>(r.ilc->getBus()) << "/" << static_cast<int>(r.address)
+                      << " already runs target firmware, skipped programming." << std::endl;
+        }
+        if (r.success == false) {
+            std::cerr << "Cannot program ILC " << static_cast<int>(r.ilc->getBus()) << "/"
+                      << static_cast<int>(r.address) << ": " << r.error << std::endl;
+            ret = -1;
+        }
+    }
+
+    return ret;
 }
 
 int FPGACliApp::openFPGA(command_vec cmds) {
@@ -20,6 +20,10 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/fmt.h>
 
@@ -33,6 +37,31 @@ ILC::ILC(uint8_t bus) {
     _broadcastCounter = 0;
     _alwaysTrigger = false;
 
+    _freezeCycle = false;
+    _freezeAddress = 248;
+    _freezeDelay = 450;
+
+    _learnTimeouts = false;
+    _timeoutFloor = 100;
+    _timeoutCeiling = 100000;
+    _timeoutPercentile = 0.99;
+    _timeoutMargin = 200;
+
+    memset(_cachedIndex, NOT_CACHED, sizeof(_cachedIndex));
+    _cachedFunctions = 0;
+    // space for status, server ID and mode change responses
+    _cachedResponse.reserve(3 * 256);
+    _cachedHash.reserve(3 * 256);
+
+    setHashRecording(true);
+
+    memset(_lastMode, UNKNOWN_MODE, sizeof(_lastMode));
+
+    memset(_adcScanRate, UNKNOWN_RATE, sizeof(_adcScanRate));
+    for (int address = 0; address < 256; address++) {
+        _lastReadout[address] = std::chrono::steady_clock::time_point::min();
+    }
+
     addResponse(
             17,
             [this](uint8_t address) {
@@ -53,6 +82,7 @@ ILC::ILC(uint8_t bus) {
                 uint8_t minorRev = read<uint8_t>();
                 std::string fwName = readString(fnLen);
                 checkCRC();
+                _firmwareRevisions[address] = FirmwareRevision{fwName, majorRev, minorRev};
                 if (responseMatchCached(address, 17) == false) {
                     processServerID(address, uniqueID, ilcAppType, networkNodeType, ilcSelectedOptions,
                                     networkNodeOptions, majorRev, minorRev, fwName);
@@ -68,8 +98,9 @@ ILC::ILC(uint8_t bus) {
                 uint16_t status = read<uint16_t>();
                 uint16_t faults = read<uint16_t>();
                 checkCRC();
+                // mode can be changed by other functions, so must be always updated
+                _lastMode[address] = mode;
                 if (responseMatchCached(address, 18) == false) {
-                    _lastMode[address] = mode;
                     processServerStatus(address, mode, status, faults);
                 }
             },
@@ -81,8 +112,8 @@ ILC::ILC(uint8_t bus) {
                 recordChanges();
                 uint16_t mode = read<uint16_t>();
                 checkCRC();
+                _lastMode[address] = static_cast<uint8_t>(mode);
                 if (responseMatchCached(address, 65) == false) {
-                    _lastMode[address] = static_cast<uint8_t>(mode);
                     processChangeILCMode(address, mode);
                 }
             },
@@ -97,6 +128,16 @@ ILC::ILC(uint8_t bus) {
             },
             200);
 
+    addResponse(
+            80,
+            [this](uint8_t address) {
+                uint8_t rate = read<uint8_t>();
+                checkCRC();
+                _adcScanRate[address] = rate;
+                processADCScanRate(address, rate);
+            },
+            208);
+
     addResponse(
             107,
             [this](uint8_t address) {
@@ -150,21 +191,155 @@ uint8_t ILC::nextBroadcastCounter() {
     return _broadcastCounter;
 }
 
+void ILC::setFreezeCycle(bool freeze, uint8_t address, uint32_t delay) {
+    _freezeCycle = freeze;
+    _freezeAddress = address;
+    _freezeDelay = delay;
+}
+
+void ILC::startCycle() {
+    if (_freezeCycle) {
+        broadcastFreezeSensorValues(_freezeAddress, _freezeDelay);
+    }
+}
+
 void ILC::changeILCMode(uint8_t address, uint16_t mode) {
-    uint32_t timeout = 335;
-    try {
-        if ((getLastMode(address) == ILCMode::Standby && mode == ILCMode::FirmwareUpdate) ||
-            (getLastMode(address) == ILCMode::FirmwareUpdate && mode == ILCMode::Standby)) {
-            timeout = 100000;
-        }
-    } catch (std::out_of_range &err) {
+    uint32_t timeout = CHANGE_MODE_TIMEOUT;
+    if ((_lastMode[address] == ILCMode::Standby && mode == ILCMode::FirmwareUpdate) ||
+        (_lastMode[address] == ILCMode::FirmwareUpdate && mode == ILCMode::Standby)) {
+        timeout = FIRMWARE_UPDATE_MODE_TIMEOUT;
     }
     callFunction(address, 65, timeout, mode);
 }
 
+void ILC::broadcastILCMode(uint16_t mode, uint8_t address, uint32_t delay) {
+    uint8_t data[2] = {static_cast<uint8_t>(mode >> 8), static_cast<uint8_t>(mode & 0xFF)};
+    broadcastFunction(address, 65, nextBroadcastCounter(), delay, data, 2);
+}
+
+// ADC sample rates (Hz), indexed by scan rate code
+static const float ADC_SAMPLE_RATES[16] = {30000, 15000, 7500, 3750, 2000, 1000, 500, 100,
+                                           60,    50,    30,   25,   15,   10,   5,   2.5};
+
+void ILC::setADCScanRate(uint8_t address, uint8_t rate) {
+    getADCSampleRate(rate);
+    callFunction(address, 80, ADC_SCAN_RATE_TIMEOUT, rate);
+}
+
+float ILC::getADCSampleRate(uint8_t rate) {
+    if (rate >= 16) {
+        throw std::out_of_range(fmt::format("Invalid ADC scan rate code: {}", rate));
+    }
+    return ADC_SAMPLE_RATES[rate];
+}
+
+std::chrono::nanoseconds ILC::getSampleLatency(uint8_t address) {
+    if (_adcScanRate[address] >= 16) {
+        return std::chrono::nanoseconds::zero();
+    }
+    float rate = ADC_SAMPLE_RATES[_adcScanRate[address]];
+    return std::chrono::nanoseconds(static_cast<int64_t>(ceil(1e9 / rate)));
+}
+
+bool ILC::readoutDue(uint8_t address, std::chrono::steady_clock::time_point now) {
+    if (_lastReadout[address] != std::chrono::steady_clock::time_point::min() &&
+        now - _lastReadout[address] < getSampleLatency(address)) {
+        return false;
+    }
+    _lastReadout[address] = now;
+    return true;
+}
+
+void ILC::setDeadband(uint8_t func, size_t field, double deadband, bool relative) {
+    _getChangeFilter(func).setDeadband(field, deadband, relative);
+}
+
+void ILC::setPublishIntervals(uint8_t func, std::chrono::steady_clock::duration minInterval,
+                              std::chrono::steady_clock::duration maxInterval) {
+    _getChangeFilter(func).setPublishIntervals(minInterval, maxInterval);
+}
+
+void ILC::setLearnedTimeouts(bool learn, uint32_t floor, uint32_t ceiling, float percentile,
+                             uint32_t margin) {
+    _learnTimeouts = learn;
+    _timeoutFloor = floor;
+    _timeoutCeiling = ceiling;
+    _timeoutPercentile = percentile;
+    _timeoutMargin = margin;
+}
+
+void ILC::reportResponseTime(uint64_t begin, uint64_t end) {
+    if (_learnTimeouts == false || end < begin) {
+        return;
+    }
+    auto last = getLastResponse();
+    ResponseTimes &times = _responseTimes[_responseKey(last.first, last.second, getLastResponseTimeout())];
+    times.times[times.next] = (end - begin + 999) / 1000;
+    times.next = (times.next + 1) % ResponseTimes::SIZE;
+    if (times.count < ResponseTimes::SIZE) {
+        times.count++;
+    }
+    times.widening /= 2;
+}
+
+uint32_t ILC::getResponseTimeouts(uint8_t address, uint8_t function) {
+    uint32_t ret = 0;
+    auto it = _responseTimes.lower_bound(_responseKey(address, function, 0));
+    auto end = _responseTimes.upper_bound(_responseKey(address, function, UINT32_MAX));
+    for (; it != end; it++) {
+        ret += it->second.timeouts;
+    }
+    return ret;
+}
+
+void ILC::endOfCycle() {
+    for (auto action : _endOfCycleActions) {
+        action();
+    }
+}
+
 uint16_t ILC::getByteInstruction(uint8_t data) {
     processDataCRC(data);
-    return FIFO::TX_MASK | ((static_cast<uint16_t>(data)) << 1);
+    return encodeByte(data);
+}
+
+// minimal number of recorded response times to use learned timeout
+constexpr size_t LEARN_MIN_RESPONSES = 8;
+
+uint32_t ILC::functionTimeout(uint8_t address, uint8_t function, uint32_t timeout) {
+    if (_learnTimeouts == false) {
+        return timeout;
+    }
+    auto it = _responseTimes.find(_responseKey(address, function, timeout));
+    if (it == _responseTimes.end() || it->second.count < LEARN_MIN_RESPONSES) {
+        return timeout;
+    }
+    return _learnedTimeout(it->second, timeout);
+}
+
+void ILC::processResponseTimeout(uint8_t address, uint8_t function, uint32_t timeout) {
+    if (_learnTimeouts == false) {
+        return;
+    }
+    ResponseTimes &times = _responseTimes[_responseKey(address, function, timeout)];
+    times.timeouts++;
+    if (times.count < LEARN_MIN_RESPONSES) {
+        return;
+    }
+    // double the timeout used for the missed call
+    times.widening = std::min(times.widening + _learnedTimeout(times, timeout),
+                              std::max(_timeoutCeiling, timeout));
+}
+
+uint32_t ILC::_learnedTimeout(const ResponseTimes &times, uint32_t timeout) {
+    uint32_t sorted[ResponseTimes::SIZE];
+    std::copy(times.times, times.times + times.count, sorted);
+    size_t index = static_cast<size_t>(ceil(_timeoutPercentile * times.count));
+    index = std::min(std::max(index, static_cast<size_t>(1)), times.count) - 1;
+    std::nth_element(sorted, sorted + index, sorted + times.count);
+
+    uint32_t learned = sorted[index] + _timeoutMargin + times.widening;
+    return std::min(std::max(learned, _timeoutFloor), std::max(_timeoutCeiling, timeout));
 }
 
 uint8_t ILC::readInstructionByte() {
@@ -174,6 +349,21 @@ uint8_t ILC::readInstructionByte() {
     return (uint8_t)((getCurrentBufferAndInc() >> 1) & 0xFF);
 }
 
+uint8_t ILC::getLastMode(uint8_t address) {
+    if (_lastMode[address] == UNKNOWN_MODE) {
+        throw std::out_of_range(fmt::format("Unknown mode of ILC with address {}", address));
+    }
+    return _lastMode[address];
+}
+
+const ILC::FirmwareRevision &ILC::getFirmwareRevision(uint8_t address) {
+    auto revision = _firmwareRevisions.find(address);
+    if (revision == _firmwareRevisions.end()) {
+        throw std::out_of_range(fmt::format("Unknown firmware revision of ILC with address {}", address));
+    }
+    return revision->second;
+}
+
 const char *ILC::getModeStr(uint8_t mode) {
     switch (mode) {
         case ILCMode::Standby:
@@ -192,19 +382,31 @@ const char *ILC::getModeStr(uint8_t mode) {
 }
 
 bool ILC::responseMatchCached(uint8_t address, uint8_t func) {
-    try {
-        std::map<uint8_t, std::vector<uint8_t>> &fc = _cachedResponse.at(address);
-        try {
-            return checkRecording(fc[func]) && !_alwaysTrigger;
-        } catch (std::out_of_range &ex1) {
-            _cachedResponse[address].emplace(func, std::vector<uint8_t>());
-        }
-    } catch (std::out_of_range &ex2) {
-        _cachedResponse.emplace(std::make_pair(
-                address,
-                std::map<uint8_t, std::vector<uint8_t>>({std::make_pair(func, std::vector<uint8_t>())})));
-    }
-    return checkRecording(_cachedResponse[address][func]) && !_alwaysTrigger;
+    uint8_t index = _cachedIndex[func];
+    if (index == NOT_CACHED) {
+        index = _cachedFunctions++;
+        _cachedIndex[func] = index;
+        _cachedResponse.resize(_cachedFunctions * 256);
+        _cachedHash.resize(_cachedFunctions * 256, 0);
+    }
+    if (getHashRecording()) {
+        return checkRecording(_cachedHash[index * 256 + address]) && !_alwaysTrigger;
+    }
+    return checkRecording(_cachedResponse[index * 256 + address]) && !_alwaysTrigger;
+}
+
+bool ILC::filterChanges(uint8_t address, uint8_t func, const double *values, size_t count) {
+    if (_changeFilters[func] == nullptr || _alwaysTrigger) {
+        return true;
+    }
+    return _changeFilters[func]->changed(address, values, count, std::chrono::steady_clock::now());
+}
+
+ChangeFilter &ILC::_getChangeFilter(uint8_t func) {
+    if (_changeFilters[func] == nullptr) {
+        _changeFilters[func].reset(new ChangeFilter());
+    }
+    return *_changeFilters[func];
 }
 
 }  // namespace cRIO
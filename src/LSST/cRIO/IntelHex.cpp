@@ -21,7 +21,10 @@
  */
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 #include <spdlog/spdlog.h>
 
@@ -29,112 +32,154 @@
 
 using namespace LSST::cRIO;
 
+// image size - 16bit address space and maximal record length
+constexpr size_t IMAGE_SIZE = 0x10000 + 0xFF;
+
+/**
+ * Lookup table of hexadecimal digit values. -1 for non-hexadecimal characters.
+ */
+struct HexTable {
+    HexTable() {
+        memset(values, -1, sizeof(values));
+        for (int i = 0; i < 10; i++) {
+            values['0' + i] = i;
+        }
+        for (int i = 0; i < 6; i++) {
+            values['A' + i] = 10 + i;
+            values['a' + i] = 10 + i;
+        }
+    }
+
+    int8_t values[256];
+};
+
+static const HexTable HEX_TABLE;
+
+/**
+ * Decodes two hexadecimal digits.
+ *
+ * @return byte value, -1 if the characters aren't hexadecimal digits, or line is too short
+ */
+static inline int hexByte(const char *p, const char *end) {
+    if (end - p < 2) {
+        return -1;
+    }
+    int high = HEX_TABLE.values[static_cast<uint8_t>(p[0])];
+    int low = HEX_TABLE.values[static_cast<uint8_t>(p[1])];
+    if (high < 0 || low < 0) {
+        return -1;
+    }
+    return (high << 4) | low;
+}
+
 IntelHex::IntelHex() {}
 
 void IntelHex::load(const std::string &fileName) {
-    std::ifstream inputStream(fileName);
-    load(inputStream);
+    std::ifstream inputStream(fileName, std::ios::binary | std::ios::ate);
+    if (!inputStream) {
+        throw LoadError(0, 0xFFFF, fmt::format("Cannot open {}: {}", fileName, strerror(errno)));
+    }
+    std::string buffer(static_cast<size_t>(inputStream.tellg()), '\0');
+    inputStream.seekg(0);
+    inputStream.read(&buffer[0], buffer.size());
     inputStream.close();
+
+    load(buffer.data(), buffer.size());
 }
 
 void IntelHex::load(std::istream &inputStream) {
-    _hexData.clear();
+    std::ostringstream buffer;
+    buffer << inputStream.rdbuf();
+    std::string data = buffer.str();
+    load(data.data(), data.size());
+}
+
+void IntelHex::load(const char *buffer, size_t length) {
+    // gap pattern
+    _image.resize(IMAGE_SIZE);
+    const uint8_t pattern[4] = {0xFF, 0xFF, 0xFF, 0x00};
+    for (size_t i = 0; i + 4 <= IMAGE_SIZE; i += 4) {
+        memcpy(_image.data() + i, pattern, 4);
+    }
+    for (size_t i = IMAGE_SIZE & ~static_cast<size_t>(3); i < IMAGE_SIZE; i++) {
+        _image[i] = pattern[i % 4];
+    }
+
+    _ranges.clear();
     _lineNo = 0;
-    std::string lineText;
+
     bool extensionData = false;
-    while (std::getline(inputStream, lineText)) {
+
+    const char *end = buffer + length;
+    const char *line = buffer;
+    while (line < end) {
+        const char *eol = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (eol == NULL) {
+            eol = end;
+        }
+        const char *lineEnd = eol;
+        if (lineEnd > line && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
         _lineNo++;
-        IntelHexLine hexLine;
-        IntelRecordType::Types recordType;
-        _processLine(lineText.c_str(), &hexLine, recordType);
-        switch (recordType) {
-            case IntelRecordType::Data:
-                if (extensionData == false) {
-                    _hexData.push_back(hexLine);
-                }
-                break;
-            case IntelRecordType::ExtendedLinearAddress:
-                // ILCs doesn't support extended addressing.
-                // Ignore all data above 0xFFFF address
-                if (hexLine.data.size() != 2) {
-                    throw LoadError(
-                            _lineNo, 0xFFFF,
-                            fmt::format("Invalid extension size - expected 2, got {}", hexLine.data.size()));
-                }
-                extensionData = *(reinterpret_cast<uint16_t *>(hexLine.data.data())) > 0;
-                break;
-            case IntelRecordType::EndOfFile:
-                return;
-            default:
-                break;
+        if (_processLine(line, lineEnd, extensionData) == false) {
+            return;
         }
+        line = eol + 1;
     }
 }
 
 std::vector<uint8_t> IntelHex::getData(uint16_t &startAddress) {
-    _sortByAddress();
-
-    startAddress = _hexData.front().address;
-
-    uint16_t lastCopied = startAddress;
-
-    std::vector<uint8_t> ret;
-
-    for (auto hd : _hexData) {
-        for (uint16_t i = lastCopied; i < hd.address; i++) {
-            ret.push_back(((i % 4) == 3) ? 0x00 : 0xff);
-        }
-
-        size_t start = ret.size();
-        ret.resize(ret.size() + hd.data.size());
-        memcpy(ret.data() + start, hd.data.data(), hd.data.size());
+    View view = getView();
+    startAddress = view.startAddress;
+    return std::vector<uint8_t>(view.data, view.data + view.length);
+}
 
-        lastCopied = hd.address + hd.data.size();
+IntelHex::View IntelHex::getView() const {
+    if (_ranges.empty()) {
+        return View{0, _image.data(), 0};
     }
-
-    return ret;
+    // ranges are ordered, gaps are already filled
+    uint32_t start = _ranges.front().first;
+    return View{static_cast<uint16_t>(start), _image.data() + start, _ranges.back().second - start};
 }
 
-void IntelHex::_processLine(const char *line, IntelHexLine *hexLine, IntelRecordType::Types &recordType) {
-    int offset = 1;
-    if (line[0] != ':') {
+bool IntelHex::_processLine(const char *line, const char *end, bool &extensionData) {
+    if (line == end || line[0] != ':') {
         throw LoadError(_lineNo, 0xFFFF,
-                        fmt::format("Invalid IntelHexLine StartCode '{}' expecting '{}'", line[0], ':'));
+                        fmt::format("Invalid start code '{}' expecting '{}'",
+                                    line == end ? '\0' : line[0], ':'));
     }
 
-    unsigned int byteCount = 0;
-    unsigned int address = 0;
-    unsigned int recType = 0;
-    int returnCode = sscanf(line + offset, "%2X%4X%2X", &byteCount, &address, &recType);
-    if (returnCode != 3) {
+    const char *p = line + 1;
+
+    int byteCount = hexByte(p, end);
+    int addressHigh = hexByte(p + 2, end);
+    int addressLow = hexByte(p + 4, end);
+    int recordType = hexByte(p + 6, end);
+    if (byteCount < 0 || addressHigh < 0 || addressLow < 0 || recordType < 0) {
         throw LoadError(_lineNo, 0xFFFF, "Unable to Parse ByteCount, Address, and RecordType for line.");
     }
-    hexLine->address = (unsigned short)address;
-    recordType = static_cast<IntelRecordType::Types>(recType);
-    offset += 8;
-    for (unsigned int i = 0; i < byteCount; ++i) {
-        unsigned int value = 0;
-        returnCode = sscanf(line + offset, "%2X", &value);
-        offset += 2;
-        if (returnCode >= 0) {
-            hexLine->data.push_back(static_cast<uint8_t>(value));
-        } else {
+    uint16_t address = (addressHigh << 8) | addressLow;
+    p += 8;
+
+    uint8_t checksum = byteCount + addressHigh + addressLow + recordType;
+
+    uint8_t data[256];
+    for (int i = 0; i < byteCount; i++) {
+        int value = hexByte(p, end);
+        if (value < 0) {
             throw LoadError(_lineNo, address, "Unable to parse DataByte " + std::to_string(i));
         }
+        data[i] = value;
+        checksum += value;
+        p += 2;
     }
-    unsigned int expectedChecksum = 0;
-    returnCode = sscanf(line + offset, "%2X", &expectedChecksum);
-    if (returnCode != 1) {
+
+    int expectedChecksum = hexByte(p, end);
+    if (expectedChecksum < 0) {
         throw LoadError(_lineNo, address, "Unable to parse Checksum");
     }
-    uint8_t checksum = 0;
-    checksum += byteCount;
-    checksum += static_cast<uint8_t>((hexLine->address & 0xFF00) >> 8);
-    checksum += static_cast<uint8_t>(hexLine->address & 0x00FF);
-    checksum += recordType;
-    for (unsigned int i = 0; i < hexLine->data.size(); ++i) {
-        checksum += hexLine->data[i];
-    }
     checksum = ~checksum;
     checksum += 1;
     if (checksum != expectedChecksum) {
@@ -142,9 +187,57 @@ void IntelHex::_processLine(const char *line, IntelHexLine *hexLine, IntelRecord
                         fmt::format("Checksum mismatch, expecting 0x{:02X}, got 0x{:02X}", expectedChecksum,
                                     checksum));
     }
+
+    switch (recordType) {
+        case IntelRecordType::Data:
+            if (extensionData == false && byteCount > 0) {
+                memcpy(_image.data() + address, data, byteCount);
+                _addRange(address, address + byteCount);
+            }
+            break;
+        case IntelRecordType::ExtendedLinearAddress:
+            // ILCs doesn't support extended addressing.
+            // Ignore all data above 0xFFFF address
+            if (byteCount != 2) {
+                throw LoadError(_lineNo, 0xFFFF,
+                                fmt::format("Invalid extension size - expected 2, got {}", byteCount));
+            }
+            extensionData = (data[0] | data[1]) > 0;
+            break;
+        case IntelRecordType::EndOfFile:
+            return false;
+        default:
+            break;
+    }
+
+    return true;
 }
 
-void IntelHex::_sortByAddress() {
-    std::sort(_hexData.begin(), _hexData.end(),
-              [](IntelHexLine a, IntelHexLine b) { return a.address < b.address; });
+void IntelHex::_addRange(uint32_t start, uint32_t end) {
+    // records are usually ordered, so the range is usually appended or merged with the last one
+    if (_ranges.empty() || _ranges.back().second < start) {
+        _ranges.emplace_back(start, end);
+        return;
+    }
+
+    // first range ending at or after the start; all ranges before it end before the new range
+    auto first = std::lower_bound(
+            _ranges.begin(), _ranges.end(), start,
+            [](const std::pair<uint32_t, uint32_t> &range, uint32_t s) { return range.second < s; });
+
+    // merge all ranges touching or overlapping the new range
+    auto last = first;
+    while (last != _ranges.end() && last->first <= end) {
+        start = std::min(start, last->first);
+        end = std::max(end, last->second);
+        last++;
+    }
+
+    if (first == last) {
+        _ranges.insert(first, std::make_pair(start, end));
+        return;
+    }
+
+    *first = std::make_pair(start, end);
+    _ranges.erase(first + 1, last);
 }
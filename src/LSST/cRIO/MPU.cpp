@@ -176,6 +176,69 @@ void MPU::readHoldingRegisters(uint16_t address, uint16_t count, uint8_t timeout
     }
 }
 
+void MPU::readHoldingRegistersTelemetry(uint16_t address, uint16_t count, uint8_t telemetryOffset,
+                                        uint8_t timeout) {
+    if (telemetryOffset + count * 2 > 0x100) {
+        throw std::out_of_range(fmt::format(
+                "Cannot fit {} registers at telemetry offset {} into MPU telemetry", count, telemetryOffset));
+    }
+
+    // replies aren't processed by processResponse, so the function isn't pushed into commanded
+    size_t start = getLength();
+
+    write(_mpu_address);
+    write<uint8_t>(3);
+    write(address);
+    write(count);
+
+    writeCRC();
+    writeEndOfFrame();
+    writeWaitForRx(0);
+
+    // write request
+    _commands.push_back(MPUCommands::WRITE);
+    _commands.push_back(getLength() - start);
+    for (size_t i = start; i < getLength(); i++) {
+        _commands.push_back(getBuffer()[i]);
+    }
+
+    _commands.push_back(MPUCommands::WAIT_MS);
+    _commands.push_back(timeout);
+
+    // read response
+    _commands.push_back(MPUCommands::READ);
+    // extras: device address, function, length (all 1 byte), CRC (2 bytes) = 5 total
+    _commands.push_back(5 + count * 2);
+    _commands.push_back(MPUCommands::CHECK_CRC);
+
+    // copy register values into telemetry. Register values start after
+    // device address, function and length
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t offset = telemetryOffset + i * 2;
+        _commands.push_back(MPUCommands::TELEMETRY_16);
+        _commands.push_back(3 + i * 2);
+        _commands.push_back(offset);
+        _telemetryRegisters[offset] = address + i;
+    }
+}
+
+size_t MPU::getTelemetryLength() {
+    if (_telemetryRegisters.empty()) {
+        return 0;
+    }
+    return _telemetryRegisters.rbegin()->first + 2;
+}
+
+void MPU::processTelemetry(uint8_t* telemetry, size_t length) {
+    if (length < getTelemetryLength()) {
+        throw std::runtime_error(fmt::format("Too short MPU telemetry - received {} bytes, expected {}",
+                                             length, getTelemetryLength()));
+    }
+    for (auto tr : _telemetryRegisters) {
+        _registers[tr.second] = (telemetry[tr.first] << 8) | telemetry[tr.first + 1];
+    }
+}
+
 void MPU::presetHoldingRegister(uint16_t address, uint16_t value, uint8_t timeout) {
     write(_mpu_address);
     write<uint8_t>(6);
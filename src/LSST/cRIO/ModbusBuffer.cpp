@@ -32,7 +32,11 @@ using namespace std;
 namespace LSST {
 namespace cRIO {
 
-ModbusBuffer::ModbusBuffer() { clear(); }
+// 64bit FNV-1a hash constants
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+ModbusBuffer::ModbusBuffer() : _hashRecording(false) { clear(); }
 
 ModbusBuffer::~ModbusBuffer() {}
 
@@ -41,11 +45,12 @@ void ModbusBuffer::reset() {
     _crc.reset();
     _recordChanges = false;
     _records.clear();
+    _recordHash = FNV_OFFSET_BASIS;
 }
 
 void ModbusBuffer::clear(bool onlyBuffers) {
     _buffer.clear();
-    std::queue<std::pair<uint8_t, uint8_t>> emptyQ;
+    std::queue<Commanded> emptyQ;
     if (onlyBuffers == false) {
         _commanded.swap(emptyQ);
     }
@@ -163,13 +168,23 @@ void ModbusBuffer::checkCommandedEmpty() {
     if (_commanded.empty()) {
         return;
     }
+    if (_tolerateMissing) {
+        while (!_commanded.empty()) {
+            auto c = _commanded.front();
+            _commanded.pop();
+            processResponseTimeout(c.address, c.function, c.timeout);
+            processMissingResponse(c.address, c.function);
+        }
+        return;
+    }
     std::ostringstream os;
     while (!_commanded.empty()) {
         if (os.str().length() > 0) {
             os << ",";
         }
         auto c = _commanded.front();
-        os << +(c.first) << ":" << +(c.second);
+        processResponseTimeout(c.address, c.function, c.timeout);
+        os << +(c.address) << ":" << +(c.function);
         _commanded.pop();
     }
     throw std::runtime_error("Responses for those <address:function> pairs weren't received: " + os.str());
@@ -241,6 +256,17 @@ void ModbusBuffer::CRC::add(uint8_t data) {
     }
 }
 
+uint16_t ModbusBuffer::CRC::delta(uint8_t change, size_t trailing) {
+    // CRC without initial value of the message with only the changed byte set
+    CRC crc;
+    crc._crcCounter = 0;
+    crc.add(change);
+    for (size_t i = 0; i < trailing; i++) {
+        crc.add(0);
+    }
+    return crc.get();
+}
+
 ModbusBuffer::CRCError::CRCError(uint16_t calculated, uint16_t received)
         : std::runtime_error(fmt::format("checkCRC invalid CRC - expected 0x{:04x}, got 0x{:04x}", calculated,
                                          received)) {}
@@ -264,7 +290,11 @@ uint16_t ModbusBuffer::getByteInstruction(uint8_t data) {
 
 void ModbusBuffer::processDataCRC(uint8_t data) {
     if (_recordChanges) {
-        _records.push_back(data);
+        if (_hashRecording) {
+            _recordHash = (_recordHash ^ data) * FNV_PRIME;
+        } else {
+            _records.push_back(data);
+        }
     }
 
     _crc.add(data);
@@ -282,9 +312,9 @@ void ModbusBuffer::callFunction(uint8_t address, uint8_t function, uint32_t time
     write(function);
     writeCRC();
     writeEndOfFrame();
-    writeWaitForRx(timeout);
+    writeWaitForRx(functionTimeout(address, function, timeout));
 
-    pushCommanded(address, function);
+    pushCommanded(address, function, timeout);
 }
 
 void ModbusBuffer::broadcastFunction(uint8_t address, uint8_t function, uint8_t counter, uint32_t delay,
@@ -304,14 +334,29 @@ void ModbusBuffer::checkCommanded(uint8_t address, uint8_t function) {
     if (_commanded.empty()) {
         throw UnmatchedFunction(address, function);
     }
-    std::pair<uint8_t, uint8_t> last = _commanded.front();
+    Commanded last = _commanded.front();
     _commanded.pop();
-    if (last.first != address || last.second != function) {
-        throw UnmatchedFunction(address, function, last.first, last.second);
+    // skip commands without reply
+    while (_tolerateMissing && (last.address != address || last.function != function)) {
+        processResponseTimeout(last.address, last.function, last.timeout);
+        processMissingResponse(last.address, last.function);
+        if (_commanded.empty()) {
+            throw UnmatchedFunction(address, function);
+        }
+        last = _commanded.front();
+        _commanded.pop();
+    }
+    if (last.address != address || last.function != function) {
+        throw UnmatchedFunction(address, function, last.address, last.function);
     }
+    _lastResponse = std::make_pair(last.address, last.function);
+    _lastResponseTimeout = last.timeout;
 }
 
 bool ModbusBuffer::checkRecording(std::vector<uint8_t>& cached) {
+    if (_hashRecording) {
+        throw std::runtime_error("Full response check called with hash recording enabled");
+    }
     _recordChanges = false;
     if (cached == _records) {
         _records.clear();
@@ -322,9 +367,23 @@ bool ModbusBuffer::checkRecording(std::vector<uint8_t>& cached) {
     return false;
 }
 
-void ModbusBuffer::pushCommanded(uint8_t address, uint8_t function) {
+bool ModbusBuffer::checkRecording(uint64_t& cached) {
+    if (_hashRecording == false) {
+        throw std::runtime_error("Hash check called with hash recording disabled");
+    }
+    _recordChanges = false;
+    uint64_t hash = _recordHash;
+    _recordHash = FNV_OFFSET_BASIS;
+    if (cached == hash) {
+        return true;
+    }
+    cached = hash;
+    return false;
+}
+
+void ModbusBuffer::pushCommanded(uint8_t address, uint8_t function, uint32_t timeout) {
     if ((address > 0 && address < 248) || (address == 255)) {
-        _commanded.push(std::pair<uint8_t, uint8_t>(address, function));
+        _commanded.push(Commanded{address, function, timeout});
     }
 }
 
@@ -0,0 +1,118 @@
+/*
+ * Concurrent firmware programming of ILCs on multiple buses.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <exception>
+#include <map>
+
+#include <cRIO/ParallelProgrammer.h>
+
+using namespace LSST::cRIO;
+
+ParallelProgrammer::ParallelProgrammer(FPGA* fpga) : _fpga(fpga) {}
+
+void ParallelProgrammer::add(PrintILC* ilc, uint8_t address) {
+    for (auto& bus : _buses) {
+        if (bus.ilc == ilc) {
+            bus.addresses.push_back(address);
+            return;
+        }
+    }
+    _buses.push_back(Bus{ilc, {address}, 0, false});
+}
+
+std::vector<ParallelProgrammer::Result> ParallelProgrammer::program(IntelHex& hex) {
+    return program(std::make_shared<const PreparedFirmware>(hex));
+}
+
+std::vector<ParallelProgrammer::Result> ParallelProgrammer::program(
+        std::shared_ptr<const PreparedFirmware> firmware) {
+    std::vector<Result> results;
+
+    for (auto& bus : _buses) {
+        bus.active = _startNext(bus, firmware, results);
+    }
+
+    while (true) {
+        std::vector<ILC*> commanded;
+        for (auto& bus : _buses) {
+            while (bus.active) {
+                try {
+                    if (bus.ilc->writeProgramStep()) {
+                        commanded.push_back(bus.ilc);
+                        break;
+                    }
+                    _finish(bus, true, "", results);
+                } catch (std::exception& e) {
+                    _finish(bus, false, e.what(), results);
+                }
+                bus.active = _startNext(bus, firmware, results);
+            }
+        }
+
+        if (commanded.empty()) {
+            break;
+        }
+
+        std::map<ILC*, std::exception_ptr> errors;
+        _fpga->ilcCommands(commanded, 5000, &errors);
+
+        for (auto& bus : _buses) {
+            if (bus.active == false) {
+                continue;
+            }
+            auto error = errors.find(bus.ilc);
+            if (error == errors.end()) {
+                processProgress(bus.ilc, bus.address, bus.ilc->getProgramStepName(),
+                                bus.ilc->getProgramProgress());
+                continue;
+            }
+            try {
+                std::rethrow_exception(error->second);
+            } catch (std::exception& e) {
+                _finish(bus, false, e.what(), results);
+            }
+            bus.active = _startNext(bus, firmware, results);
+        }
+    }
+
+    return results;
+}
+
+void ParallelProgrammer::_finish(Bus& bus, bool success, std::string error, std::vector<Result>& results) {
+    results.push_back(Result{bus.ilc, bus.address, success, success && bus.ilc->isProgramSkipped(), error});
+    processResult(results.back());
+}
+
+bool ParallelProgrammer::_startNext(Bus& bus, const std::shared_ptr<const PreparedFirmware>& firmware,
+                                    std::vector<Result>& results) {
+    while (!bus.addresses.empty()) {
+        bus.address = bus.addresses.front();
+        bus.addresses.pop_front();
+        try {
+            bus.ilc->startProgramming(bus.address, firmware);
+            return true;
+        } catch (std::exception& e) {
+            _finish(bus, false, e.what(), results);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,156 @@
+/*
+ * Pneumatic (force actuator) ILC functions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cRIO/PneumaticILC.h>
+
+namespace LSST {
+namespace cRIO {
+
+// I24 range limits
+constexpr int32_t I24_MAX = 0x7FFFFF;
+constexpr int32_t I24_MIN = -0x800000;
+
+PneumaticILC::PneumaticILC(uint8_t bus) : ILC(bus), _forceStatusArrays(nullptr) {
+    for (int address = 0; address < 256; address++) {
+        _faIndex[address] = -1;
+    }
+
+    auto forceStatus = [this](uint8_t address, uint8_t func) {
+        uint8_t status = read<uint8_t>();
+        float primary = read<float>();
+        float secondary = NAN;
+        if (isDAA(address)) {
+            secondary = read<float>();
+        }
+        checkCRC();
+        int index = _faIndex[address];
+        if (_forceStatusArrays != nullptr && index >= 0) {
+            _forceStatusArrays->status[index] = status;
+            _forceStatusArrays->primaryForce[index] = primary;
+            _forceStatusArrays->secondaryForce[index] = secondary;
+            _forceStatusArrays->reported.set(index);
+            _reported.set(index);
+            return;
+        }
+        double values[3] = {static_cast<double>(status), primary, secondary};
+        if (filterChanges(address, func, values, 3)) {
+            processForceStatus(address, status, primary, secondary);
+        }
+    };
+
+    addResponse(
+            75, [forceStatus](uint8_t address) { forceStatus(address, 75); }, 203);
+
+    addResponse(
+            76, [forceStatus](uint8_t address) { forceStatus(address, 76); }, 204);
+
+    addEndOfCycleAction([this]() {
+        if (_reported.none()) {
+            return;
+        }
+        if ((_reported & _expected) == _expected) {
+            processForceStatusArrays();
+        }
+        _reported.reset();
+    });
+}
+
+void PneumaticILC::setForceActuator(uint8_t address, int index) {
+    if (address == 0 || address > SAA_SLOTS + DAA_SLOTS) {
+        throw std::out_of_range(fmt::format("Invalid force actuator ILC address: {}", address));
+    }
+    if (index < 0 || index >= FA_COUNT) {
+        throw std::out_of_range(fmt::format("Invalid force actuator index: {}", index));
+    }
+    _faIndex[address] = index;
+
+    _expected.reset();
+    for (auto i : _faIndex) {
+        if (i >= 0) {
+            _expected.set(i);
+        }
+    }
+}
+
+void PneumaticILC::setForceDemand(uint8_t address, bool slewFlag, float primary, float secondary) {
+    write(address);
+    write<uint8_t>(75);
+    write<uint8_t>(slewFlag ? 0xFF : 0x00);
+    _writeForce(primary);
+    if (isDAA(address)) {
+        _writeForce(secondary);
+    }
+    writeCRC();
+    writeEndOfFrame();
+    writeWaitForRx(functionTimeout(address, 75, FORCE_TIMEOUT));
+
+    pushCommanded(address, 75, FORCE_TIMEOUT);
+}
+
+void PneumaticILC::broadcastForceDemand(bool slewFlag, const float primary[FA_COUNT],
+                                        const float secondary[FA_COUNT]) {
+    write<uint8_t>(248);
+    write<uint8_t>(75);
+    write(nextBroadcastCounter());
+    write<uint8_t>(slewFlag ? 0xFF : 0x00);
+
+    for (int address = 1; address <= SAA_SLOTS; address++) {
+        int index = _faIndex[address];
+        _writeForce(index < 0 ? 0 : primary[index]);
+    }
+
+    for (int address = SAA_SLOTS + 1; address <= SAA_SLOTS + DAA_SLOTS; address++) {
+        int index = _faIndex[address];
+        if (index < 0) {
+            writeI24(0);
+            writeI24(0);
+        } else {
+            _writeForce(primary[index]);
+            _writeForce(secondary[index]);
+        }
+    }
+
+    writeCRC();
+    writeEndOfFrame();
+    writeDelay(150);
+}
+
+void PneumaticILC::_writeForce(float force) {
+    // quantize to mN, saturate to I24 range
+    float mN = roundf(force * 1000.0f);
+    int32_t value = 0;
+    if (mN >= I24_MAX) {
+        value = I24_MAX;
+    } else if (mN <= I24_MIN) {
+        value = I24_MIN;
+    } else if (!std::isnan(mN)) {
+        value = static_cast<int32_t>(mN);
+    }
+    writeI24(value);
+}
+
+}  // namespace cRIO
+}  // namespace LSST
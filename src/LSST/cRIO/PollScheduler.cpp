@@ -0,0 +1,157 @@
+/*
+ * Rate group scheduler of ILC polls.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cRIO/PollScheduler.h>
+
+using namespace LSST::cRIO;
+
+// maximal number of cycles in which load is balanced
+constexpr unsigned int MAX_HYPERPERIOD = 10000;
+
+PollScheduler::PollScheduler(float cycleRate) : _cycleRate(cycleRate), _cycle(0) {}
+
+void PollScheduler::addRateGroup(ILC* ilc, float rate, const std::vector<uint8_t>& addresses,
+                                 PollFunction poll, bool sensorReadout) {
+    if (rate <= 0 || rate > _cycleRate) {
+        throw std::out_of_range(
+                fmt::format("Invalid rate group rate {} Hz, cycle rate is {} Hz", rate, _cycleRate));
+    }
+
+    RateGroup group;
+    group.ilc = ilc;
+    group.rate = rate;
+    group.divider = std::max(1u, static_cast<unsigned int>(round(_cycleRate / rate)));
+    group.addresses = addresses;
+    group.poll = poll;
+    group.sensorReadout = sensorReadout;
+
+    auto pos = std::upper_bound(_groups.begin(), _groups.end(), rate,
+                                [](float r, const RateGroup& g) { return r > g.rate; });
+    _groups.insert(pos, group);
+
+    _schedule();
+}
+
+void PollScheduler::pollOnDemand(ILC* ilc, uint8_t address, PollFunction poll) {
+    _onDemand.push_back(OnDemand{ilc, address, poll});
+}
+
+std::vector<ILC*> PollScheduler::cycle(std::chrono::steady_clock::time_point now) {
+    std::vector<ILC*> ilcs;
+    // ILCs with sensor readouts in the cycle
+    std::vector<ILC*> readouts;
+
+    auto useILC = [&ilcs](ILC* ilc) {
+        if (std::find(ilcs.begin(), ilcs.end(), ilc) == ilcs.end()) {
+            ilc->clear();
+            ilcs.push_back(ilc);
+        }
+    };
+
+    // freeze broadcast is written only on buses with sensor readouts
+    auto startReadout = [&readouts](ILC* ilc) {
+        if (std::find(readouts.begin(), readouts.end(), ilc) == readouts.end()) {
+            ilc->startCycle();
+            readouts.push_back(ilc);
+        }
+    };
+
+    for (auto& group : _groups) {
+        unsigned int phase = _cycle % group.divider;
+        for (size_t i = 0; i < group.addresses.size(); i++) {
+            if (group.phases[i] != phase && group.retry[i] == false) {
+                continue;
+            }
+            if (group.sensorReadout) {
+                // ILC hasn't yet acquired a new sample - retry in the next cycle
+                if (group.ilc->readoutDue(group.addresses[i], now) == false) {
+                    group.retry[i] = true;
+                    continue;
+                }
+                group.retry[i] = false;
+            }
+            useILC(group.ilc);
+            if (group.sensorReadout) {
+                startReadout(group.ilc);
+            }
+            group.poll(group.addresses[i]);
+        }
+    }
+
+    for (auto& onDemand : _onDemand) {
+        useILC(onDemand.ilc);
+        onDemand.poll(onDemand.address);
+    }
+    _onDemand.clear();
+
+    _cycle++;
+
+    return ilcs;
+}
+
+void PollScheduler::_schedule() {
+    // load is balanced over hyperperiod - least common multiple of group dividers
+    unsigned int hyperperiod = 1;
+    for (auto& group : _groups) {
+        unsigned int a = hyperperiod, b = group.divider;
+        while (b != 0) {
+            unsigned int t = a % b;
+            a = b;
+            b = t;
+        }
+        hyperperiod = std::min(hyperperiod / a * group.divider, MAX_HYPERPERIOD);
+    }
+
+    std::vector<unsigned int> load(hyperperiod, 0);
+
+    // groups are sorted by rate, so polls with the highest rate are placed first
+    for (auto& group : _groups) {
+        group.phases.resize(group.addresses.size());
+        group.retry.resize(group.addresses.size(), false);
+        unsigned int repeats = std::max(1u, hyperperiod / group.divider);
+        for (size_t i = 0; i < group.addresses.size(); i++) {
+            unsigned int bestPhase = 0;
+            unsigned int bestLoad = UINT32_MAX;
+            for (unsigned int phase = 0; phase < group.divider; phase++) {
+                unsigned int maxLoad = 0;
+                for (unsigned int k = 0; k < repeats; k++) {
+                    maxLoad = std::max(maxLoad, load[(phase + k * group.divider) % hyperperiod]);
+                }
+                if (maxLoad < bestLoad) {
+                    bestLoad = maxLoad;
+                    bestPhase = phase;
+                }
+            }
+            group.phases[i] = bestPhase;
+            for (unsigned int k = 0; k < repeats; k++) {
+                load[(bestPhase + k * group.divider) % hyperperiod]++;
+            }
+        }
+    }
+}
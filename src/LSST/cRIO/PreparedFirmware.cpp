@@ -0,0 +1,100 @@
+/*
+ * Firmware prepared for ILC programming.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <cRIO/ILC.h>
+#include <cRIO/ModbusBuffer.h>
+#include <cRIO/PreparedFirmware.h>
+
+using namespace LSST::cRIO;
+
+PreparedFirmware::PreparedFirmware(IntelHex& hex) {
+    IntelHex::View view = hex.getView();
+    _startAddress = view.startAddress;
+
+    // CRC is calculated only from data, skips filling
+    ModbusBuffer::CRC crc;
+    for (size_t i = 0; i < view.length; i++) {
+        crc.add(view.data[i]);
+    }
+    _dataCRC = crc.get();
+
+    _dataLength = view.length;
+
+    size_t pages = (view.length + 255) / 256;
+    _frames.resize(pages * PAGE_FRAME_LENGTH);
+    _frameCRCs.resize(pages);
+
+    uint16_t* frame = _frames.data();
+    for (size_t page = 0; page < pages; page++) {
+        // full pages are read directly from the image, the last page is aligned to 256 bytes
+        const uint8_t* pageData = view.data + page * 256;
+        uint8_t lastPage[256];
+        size_t remaining = view.length - page * 256;
+        if (remaining < 256) {
+            memcpy(lastPage, pageData, remaining);
+            for (size_t i = remaining; i < 256; i++) {
+                lastPage[i] = ((i % 4) == 3) ? 0x00 : 0xFF;
+            }
+            pageData = lastPage;
+        }
+
+        uint16_t pageAddress = _startAddress + page * 256;
+        uint8_t bytes[PAGE_FRAME_LENGTH - 2] = {0, 102, static_cast<uint8_t>(pageAddress >> 8),
+                                                static_cast<uint8_t>(pageAddress & 0xFF), 0, 192};
+        uint8_t* b = bytes + 6;
+        for (int i = 0; i < 64; i++) {
+            memcpy(b, pageData, 3);
+            b += 3;
+            // skip every fourth byte
+            pageData += 4;
+        }
+
+        crc.reset();
+        for (auto d : bytes) {
+            crc.add(d);
+            *frame = ILC::encodeByte(d);
+            frame++;
+        }
+        _frameCRCs[page] = crc.get();
+        frame[0] = ILC::encodeByte(crc.get() & 0xFF);
+        frame[1] = ILC::encodeByte(crc.get() >> 8);
+        frame += 2;
+    }
+
+    for (int address = 0; address < 256; address++) {
+        _addressCRCDelta[address] = ModbusBuffer::CRC::delta(address, PAGE_FRAME_LENGTH - 3);
+    }
+}
+
+void PreparedFirmware::writePageFrame(size_t page, uint8_t address, uint16_t* frame) const {
+    const uint16_t* source = _frames.data() + page * PAGE_FRAME_LENGTH;
+    memcpy(frame, source, PAGE_FRAME_LENGTH * sizeof(uint16_t));
+
+    frame[0] = ILC::encodeByte(address);
+
+    // frames are prepared for address 0, CRC of address change is applied
+    uint16_t crc = _frameCRCs[page] ^ _addressCRCDelta[address];
+    frame[PAGE_FRAME_LENGTH - 2] = ILC::encodeByte(crc & 0xFF);
+    frame[PAGE_FRAME_LENGTH - 1] = ILC::encodeByte(crc >> 8);
+}
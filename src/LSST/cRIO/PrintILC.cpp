@@ -22,6 +22,9 @@
 
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
 
 #include <cRIO/ModbusBuffer.h>
 #include <cRIO/PrintILC.h>
@@ -29,7 +32,18 @@
 
 using namespace LSST::cRIO;
 
-PrintILC::PrintILC(uint8_t bus) : ILC(bus), _printout(0), _lastAddress(0) {
+PrintILC::PrintILC(uint8_t bus)
+        : ILC(bus),
+          _printout(0),
+          _lastAddress(0),
+          _targetFirmwareSet(false),
+          _forceProgramming(false),
+          _programSkipped(false),
+          _pagesPerTransaction(1),
+          _maxTransactionLength(4096),
+          _programStep(Done),
+          _programAddress(0),
+          _programPage(0) {
     setAlwaysTrigger(true);
 
     addResponse(
@@ -93,83 +107,188 @@ void PrintILC::writeApplicationPage(uint8_t address, uint16_t startAddress, uint
     writeBuffer(data, length);
     writeCRC();
     writeEndOfFrame();
-    writeWaitForRx(500000);
+    writeWaitForRx(functionTimeout(address, 102, 500000));
 
-    pushCommanded(address, 102);
+    pushCommanded(address, 102, 500000);
 }
 
-void PrintILC::programILC(FPGA *fpga, uint8_t address, IntelHex &hex) {
-    clear();
-
-    reportServerStatus(address);
-    fpga->ilcCommands(*this);
-    clear();
+// length of a page write command - page frame, end of frame and wait for rx
+constexpr size_t PAGE_COMMAND_LENGTH = PreparedFirmware::PAGE_FRAME_LENGTH + 1 + 1;
 
-    switch (getLastMode(address)) {
-        // those modes need fault first
-        case ILCMode::Enabled:
-            changeILCMode(address, ILCMode::Disabled);
-        case ILCMode::Disabled:
-            changeILCMode(address, ILCMode::Standby);
-            break;
-        case ILC::ILCMode::Fault:
-            changeILCMode(address, ILCMode::ClearFaults);
-            break;
-        default:
-            break;
+void PrintILC::setPagesPerTransaction(size_t pages, size_t maxLength) {
+    if (pages == 0 || maxLength < PAGE_COMMAND_LENGTH) {
+        throw std::out_of_range(fmt::format(
+                "Invalid number of pages per transaction: {} pages, {} words transaction", pages, maxLength));
     }
+    _pagesPerTransaction = pages;
+    _maxTransactionLength = maxLength;
+}
 
-    fpga->ilcCommands(*this);
-    clear();
+void PrintILC::setTargetFirmware(const std::string &name, uint8_t majorRev, uint8_t minorRev) {
+    _targetFirmware = FirmwareRevision{name, majorRev, minorRev};
+    _targetFirmwareSet = true;
+}
 
-    if (getLastMode(address) != ILC::FirmwareUpdate) {
-        changeILCMode(address, ILCMode::FirmwareUpdate);
-        fpga->ilcCommands(*this);
-        clear();
-    }
+void PrintILC::programILC(FPGA *fpga, uint8_t address, IntelHex &hex) {
+    startProgramming(address, hex);
 
-    if (getLastMode(address) == ILC::Fault) {
-        changeILCMode(address, ILCMode::ClearFaults);
+    while (writeProgramStep()) {
         fpga->ilcCommands(*this);
-        clear();
-    }
-
-    if (getLastMode(address) != ILC::FirmwareUpdate) {
-        throw std::runtime_error("Cannot transition to FirmwareUpdate mode");
     }
 
-    eraseILCApplication(address);
-    fpga->ilcCommands(*this);
     clear();
+}
 
-    _startAddress = 0;
-    _dataLength = 0;
+void PrintILC::startProgramming(uint8_t address, IntelHex &hex) {
+    startProgramming(address, std::make_shared<const PreparedFirmware>(hex));
+}
 
-    _crc.reset();
+void PrintILC::startProgramming(uint8_t address, std::shared_ptr<const PreparedFirmware> firmware) {
+    _programAddress = address;
+    _programStep = ReadStatus;
+    _programSkipped = false;
 
-    _writeHex(fpga, address, hex);
+    _firmware = firmware;
+    _programPage = 0;
+}
 
-    writeApplicationStats(address, _crc.get(), _startAddress, _dataLength);
-    fpga->ilcCommands(*this);
+bool PrintILC::writeProgramStep() {
     clear();
 
-    writeVerifyApplication(address);
-    fpga->ilcCommands(*this);
-    clear();
+    uint8_t address = _programAddress;
+
+    // steps without commands are skipped
+    while (getLength() == 0) {
+        switch (_programStep) {
+            case ReadStatus:
+                if (_targetFirmwareSet && !_forceProgramming) {
+                    reportServerID(address);
+                }
+                reportServerStatus(address);
+                _programStep = CheckFirmware;
+                break;
+            case CheckFirmware:
+                if (_targetFirmwareSet && !_forceProgramming) {
+                    auto &revision = getFirmwareRevision(address);
+                    if (revision.name == _targetFirmware.name &&
+                        revision.majorRev == _targetFirmware.majorRev &&
+                        revision.minorRev == _targetFirmware.minorRev) {
+                        _programSkipped = true;
+                        _programStep = Done;
+                        return false;
+                    }
+                }
+                _programStep = LeaveMode;
+                break;
+            case LeaveMode:
+                switch (getLastMode(address)) {
+                    // those modes need fault first
+                    case ILCMode::Enabled:
+                        changeILCMode(address, ILCMode::Disabled);
+                    case ILCMode::Disabled:
+                        changeILCMode(address, ILCMode::Standby);
+                        break;
+                    case ILC::ILCMode::Fault:
+                        changeILCMode(address, ILCMode::ClearFaults);
+                        break;
+                    default:
+                        break;
+                }
+                _programStep = EnterFirmwareUpdate;
+                break;
+            case EnterFirmwareUpdate:
+                if (getLastMode(address) != ILC::FirmwareUpdate) {
+                    changeILCMode(address, ILCMode::FirmwareUpdate);
+                }
+                _programStep = ClearUpdateFaults;
+                break;
+            case ClearUpdateFaults:
+                if (getLastMode(address) == ILC::Fault) {
+                    changeILCMode(address, ILCMode::ClearFaults);
+                }
+                _programStep = Erase;
+                break;
+            case Erase:
+                if (getLastMode(address) != ILC::FirmwareUpdate) {
+                    throw std::runtime_error("Cannot transition to FirmwareUpdate mode");
+                }
+                eraseILCApplication(address);
+                _programStep = WritePages;
+                break;
+            case WritePages:
+                if (_programPage < _firmware->getPageCount()) {
+                    for (size_t p = 0; p < _pagesPerTransaction && _programPage < _firmware->getPageCount() &&
+                                       getLength() + PAGE_COMMAND_LENGTH <= _maxTransactionLength;
+                         p++) {
+                        _writePage();
+                    }
+                } else {
+                    _programStep = WriteStats;
+                }
+                break;
+            case WriteStats:
+                writeApplicationStats(address, _firmware->getDataCRC(), _firmware->getStartAddress(),
+                                      _firmware->getDataLength());
+                _programStep = Verify;
+                break;
+            case Verify:
+                writeVerifyApplication(address);
+                _programStep = EnterStandby;
+                break;
+            case EnterStandby:
+                changeILCMode(address, ILCMode::Standby);
+                _programStep = ClearStandbyFaults;
+                break;
+            case ClearStandbyFaults:
+                if (getLastMode(address) == ILC::Fault) {
+                    changeILCMode(address, ILCMode::ClearFaults);
+                }
+                _programStep = EnterDisabled;
+                break;
+            case EnterDisabled:
+                changeILCMode(address, ILCMode::Disabled);
+                _programStep = Done;
+                break;
+            case Done:
+                return false;
+        }
+    }
 
-    changeILCMode(address, ILCMode::Standby);
-    fpga->ilcCommands(*this);
-    clear();
+    return true;
+}
 
-    if (getLastMode(address) == ILC::Fault) {
-        changeILCMode(address, ILCMode::ClearFaults);
-        fpga->ilcCommands(*this);
-        clear();
+const char *PrintILC::getProgramStepName() {
+    switch (_programStep) {
+        case ReadStatus:
+        case CheckFirmware:
+            return "reading status";
+        case LeaveMode:
+        case EnterFirmwareUpdate:
+        case ClearUpdateFaults:
+            return "entering firmware update";
+        case Erase:
+            return "erasing";
+        case WritePages:
+            return "writing pages";
+        case WriteStats:
+            return "writing stats";
+        case Verify:
+            return "verifying";
+        case EnterStandby:
+        case ClearStandbyFaults:
+        case EnterDisabled:
+            return "leaving firmware update";
+        case Done:
+            return "done";
     }
+    return "unknown";
+}
 
-    changeILCMode(address, ILCMode::Disabled);
-    fpga->ilcCommands(*this);
-    clear();
+float PrintILC::getProgramProgress() {
+    if (_firmware == nullptr || _firmware->getPageCount() == 0) {
+        return 1;
+    }
+    return static_cast<float>(_programPage) / _firmware->getPageCount();
 }
 
 void PrintILC::processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType,
@@ -270,49 +389,16 @@ void PrintILC::printSepline() {
     _printout++;
 }
 
-void PrintILC::_writeHex(FPGA *fpga, uint8_t address, IntelHex &hex) {
-    // align data to 256 bytes pages
-    std::vector<uint8_t> data = hex.getData(_startAddress);
-
-    size_t mod = data.size() % 256;
-    if (mod == 0) {
-        mod = 256;
-    }
-
-    // CRC is calculated only from data, skips filling
-    for (auto d : data) {
-        _crc.add(d);
-    }
-
-    std::cout << "Writing pages ";
-
-    _dataLength = data.size();
-
-    for (int i = mod; i < 256; i++) {
-        data.push_back(((i % 4) == 3) ? 0x00 : 0xFF);
+void PrintILC::_writePage() {
+    uint16_t frame[PreparedFirmware::PAGE_FRAME_LENGTH];
+    _firmware->writePageFrame(_programPage, _programAddress, frame);
+    for (auto w : frame) {
+        pushBuffer(w);
     }
+    writeEndOfFrame();
+    writeWaitForRx(functionTimeout(_programAddress, 102, 500000));
 
-    uint8_t *startData = data.data();
-    uint8_t *endData = data.data() + data.size();
-    uint16_t dataAddress = _startAddress;
-    while (startData < endData) {
-        uint8_t page[192];
-        int i = 0;
-        while (i < 192) {
-            for (int j = 0; j < 3; j++) {
-                page[i] = *startData;
-                i++;
-                startData++;
-            }
-            // skip every fourth byte
-            startData++;
-        }
-        writeApplicationPage(address, dataAddress, 192, page);
-        fpga->ilcCommands(*this);
-
-        clear();
-        dataAddress += 256;
-    }
+    pushCommanded(_programAddress, 102, 500000);
 
-    std::cout << std::endl;
+    _programPage++;
 }
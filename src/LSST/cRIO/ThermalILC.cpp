@@ -20,35 +20,143 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <array>
+#include <cstdlib>
+#include <new>
+
 #include <cRIO/ThermalILC.h>
 
 namespace LSST {
 namespace cRIO {
 
-ThermalILC::ThermalILC(uint8_t bus) : ILC(bus) {
-    auto thermalStatus = [this](uint8_t address) {
+ThermalILC::ThermalILC(uint8_t bus)
+        : ILC(bus), _frameMode(false), _demandRefreshInterval(std::chrono::steady_clock::duration::zero()) {
+    void *frame = aligned_alloc(alignof(ThermalStatusFrame), sizeof(ThermalStatusFrame));
+    if (frame == nullptr) {
+        throw std::bad_alloc();
+    }
+    _frame.reset(new (frame) ThermalStatusFrame());
+
+    for (int address = 0; address < 256; address++) {
+        _frameIndex[address] = address - 1;
+    }
+
+    auto thermalStatus = [this](uint8_t address, uint8_t func) {
         uint8_t status = read<uint8_t>();
         float differentialTemperature = read<float>();
         uint8_t fanRPM = read<uint8_t>();
         float absoluteTemperature = read<float>();
         checkCRC();
-        processThermalStatus(address, status, differentialTemperature, fanRPM, absoluteTemperature);
+        uint8_t index = _frameIndex[address];
+        if (_frameMode && index < NUM_TS_ILC) {
+            _frame->status[index] = status;
+            _frame->differentialTemperature[index] = differentialTemperature;
+            _frame->fanRPM[index] = fanRPM;
+            _frame->absoluteTemperature[index] = absoluteTemperature;
+            _frame->valid.set(index);
+            return;
+        }
+        double values[4] = {static_cast<double>(status), differentialTemperature,
+                            static_cast<double>(fanRPM), absoluteTemperature};
+        if (filterChanges(address, func, values, 4)) {
+            processThermalStatus(address, status, differentialTemperature, fanRPM, absoluteTemperature);
+        }
     };
 
-    addResponse(88, thermalStatus, 216);
+    addResponse(
+            88, [thermalStatus](uint8_t address) { thermalStatus(address, 88); }, 216);
+
+    addResponse(
+            89, [thermalStatus](uint8_t address) { thermalStatus(address, 89); }, 217);
+
+    addEndOfCycleAction([this]() {
+        if (_frame->valid.any()) {
+            processThermalStatusFrame(*_frame);
+            _frame->valid.reset();
+        }
+    });
+}
+
+// broadcast 88 message length - address, function, counter, heater PWM & fan RPM for each ILC
+constexpr size_t DEMAND_LENGTH = 3 + NUM_TS_ILC * 2;
+
+bool ThermalILC::broadcastThermalDemand(uint8_t heaterPWM[NUM_TS_ILC], uint8_t fanRPM[NUM_TS_ILC]) {
+    auto now = std::chrono::steady_clock::now();
 
-    addResponse(89, thermalStatus, 217);
+    if (_demandFrame.empty()) {
+        _demandMessage[0] = 250;
+        _demandMessage[1] = 88;
+        _demandMessage[2] = nextBroadcastCounter();
+        for (int i = 0, o = 3; i < NUM_TS_ILC; i++, o++) {
+            _demandMessage[o] = heaterPWM[i];
+            o++;
+            _demandMessage[o] = fanRPM[i];
+        }
+
+        ModbusBuffer::CRC crc;
+        _demandFrame.reserve(DEMAND_LENGTH + 2);
+        for (auto d : _demandMessage) {
+            crc.add(d);
+            _demandFrame.push_back(encodeByte(d));
+        }
+        _demandCRC = crc.get();
+        _demandFrame.push_back(encodeByte(_demandCRC & 0xFF));
+        _demandFrame.push_back(encodeByte((_demandCRC >> 8) & 0xFF));
+    } else {
+        bool changed = false;
+        for (int i = 0, o = 3; i < NUM_TS_ILC; i++, o += 2) {
+            if (heaterPWM[i] != _demandMessage[o]) {
+                _patchDemand(o, heaterPWM[i]);
+                changed = true;
+            }
+            if (fanRPM[i] != _demandMessage[o + 1]) {
+                _patchDemand(o + 1, fanRPM[i]);
+                changed = true;
+            }
+        }
+
+        if (changed == false && now - _lastDemandBroadcast < _demandRefreshInterval) {
+            return false;
+        }
+
+        _patchDemand(2, nextBroadcastCounter());
+
+        _demandFrame[DEMAND_LENGTH] = encodeByte(_demandCRC & 0xFF);
+        _demandFrame[DEMAND_LENGTH + 1] = encodeByte((_demandCRC >> 8) & 0xFF);
+    }
+
+    for (auto w : _demandFrame) {
+        pushBuffer(w);
+    }
+    writeEndOfFrame();
+    writeDelay(450);
+
+    _lastDemandBroadcast = now;
+
+    return true;
 }
 
-void ThermalILC::broadcastThermalDemand(uint8_t heaterPWM[NUM_TS_ILC], uint8_t fanRPM[NUM_TS_ILC]) {
-    uint8_t params[NUM_TS_ILC * 2];
-    for (int i = 0, o = 0; i < NUM_TS_ILC; i++, o++) {
-        params[o] = heaterPWM[i];
-        o++;
-        params[o] = fanRPM[i];
+void ThermalILC::_patchDemand(size_t offset, uint8_t data) {
+    // CRC changes caused by a bit change at given message offset
+    static const auto bitDelta = []() {
+        std::array<std::array<uint16_t, 8>, DEMAND_LENGTH> ret;
+        for (size_t o = 0; o < DEMAND_LENGTH; o++) {
+            for (int b = 0; b < 8; b++) {
+                ret[o][b] = ModbusBuffer::CRC::delta(1 << b, DEMAND_LENGTH - o - 1);
+            }
+        }
+        return ret;
+    }();
+
+    uint8_t change = _demandMessage[offset] ^ data;
+    for (int b = 0; b < 8; b++) {
+        if (change & (1 << b)) {
+            _demandCRC ^= bitDelta[offset][b];
+        }
     }
 
-    broadcastFunction(250, 88, nextBroadcastCounter(), 450, params, NUM_TS_ILC * 2);
+    _demandMessage[offset] = data;
+    _demandFrame[offset] = encodeByte(data);
 }
 
 }  // namespace cRIO
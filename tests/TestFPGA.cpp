@@ -201,3 +201,79 @@ void TestFPGA::_ackFunction(uint8_t address, uint8_t func) {
 
     _response.writeCRC();
 }
+
+MultiBusFPGA::MultiBusFPGA()
+        : FPGA(fpgaType::SS),
+          commandWrites(0),
+          transactions(0),
+          parallelTransactions(0),
+          rxEndFrames(false),
+          _rxBus(0),
+          _readData(false) {}
+
+void MultiBusFPGA::writeCommandFIFO(uint16_t* data, size_t length, uint32_t timeout) {
+    uint16_t* d = data;
+    while (d < data + length) {
+        // modbus software trigger
+        if (*d == 252) {
+            d++;
+            continue;
+        }
+        REQUIRE(*d > 100);
+        REQUIRE(*d < 106);
+        uint8_t bus = *d - 100;
+        size_t dl = d[1];
+        _simulate(bus, d + 2, dl);
+        d += dl + 2;
+        _written.insert(bus);
+        commandWrites++;
+    }
+}
+
+void MultiBusFPGA::writeRequestFIFO(uint16_t* data, size_t length, uint32_t timeout) {
+    // commands for all buses are written before the first response is read
+    if (_written.size() > 1) {
+        parallelTransactions++;
+    }
+    _written.clear();
+    transactions++;
+    _rxBus = *data - 200;
+    _readData = false;
+}
+
+void MultiBusFPGA::readU16ResponseFIFO(uint16_t* data, size_t length, uint32_t timeout) {
+    SimulatedILC& response = _responses[_rxBus];
+    if (_readData == false) {
+        *data = response.getLength();
+        _readData = true;
+    } else {
+        REQUIRE(length == response.getLength());
+        memcpy(data, response.getBuffer(), length * 2);
+        response.clear();
+    }
+}
+
+void MultiBusFPGA::_simulate(uint8_t bus, uint16_t* data, size_t length) {
+    SimulatedILC& response = _responses[bus];
+    response.writeFPGATimestamp(0);
+
+    PrintILC buf(bus);
+    buf.setBuffer(data, length);
+    while (!buf.endOfBuffer()) {
+        if ((buf.peek() & FIFO::CMD_MASK) != FIFO::WRITE) {
+            buf.next();
+            continue;
+        }
+        uint8_t address = buf.read<uint8_t>();
+        uint8_t func = buf.read<uint8_t>();
+        if (simulateCommand(bus, address, func, buf, response) == false) {
+            continue;
+        }
+        response.writeCRC();
+        if (rxEndFrames) {
+            response.writeEndOfFrame();
+        }
+        response.writeRxTimestamp(getRxTimestamp(bus, address));
+        response.writeRxEndFrame();
+    }
+}
@@ -23,6 +23,10 @@
 #ifndef __TEST_FPGA__
 #define __TEST_FPGA__
 
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <cRIO/FPGA.h>
 #include <cRIO/PrintILC.h>
 #include <cRIO/SimulatedILC.h>
@@ -48,8 +52,8 @@ public:
     uint16_t getTxCommand(uint8_t bus) override { return FPGAAddress::MODBUS_A_TX; }
     uint16_t getRxCommand(uint8_t bus) override { return FPGAAddress::MODBUS_A_RX; }
     uint32_t getIrq(uint8_t bus) override { return 1; }
-    void writeMPUFIFO(LSST::cRIO::MPU&) override {}
-    void readMPUFIFO(LSST::cRIO::MPU&) override {}
+    void writeMPUFIFO(LSST::cRIO::MPU& mpu) override { mpuCalls.emplace_back('W', &mpu); }
+    void readMPUFIFO(LSST::cRIO::MPU& mpu) override { mpuCalls.emplace_back('R', &mpu); }
     void writeCommandFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
     void writeRequestFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
     void readU16ResponseFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
@@ -58,6 +62,9 @@ public:
 
     void setPages(uint8_t* pages) { _pages = pages; }
 
+    // recorded MPU FIFO calls - W for write, R for read
+    std::vector<std::pair<char, LSST::cRIO::MPU*>> mpuCalls;
+
 protected:
     void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override;
     void processChangeILCMode(uint8_t address, uint16_t mode) override;
@@ -77,4 +84,75 @@ private:
     double _currentTimestamp;
 };
 
+/**
+ * Simulates FPGA with ILCs on multiple buses (1-5). ILC commands written to a
+ * bus are passed to simulateCommand, replies are read from the bus response
+ * FIFO.
+ */
+class MultiBusFPGA : public LSST::cRIO::FPGA {
+public:
+    MultiBusFPGA();
+
+    void initialize() override {}
+    void open() override {}
+    void close() override {}
+    void finalize() override {}
+    uint16_t getTxCommand(uint8_t bus) override { return 100 + bus; }
+    uint16_t getRxCommand(uint8_t bus) override { return 200 + bus; }
+    uint32_t getIrq(uint8_t bus) override { return 1 << bus; }
+    void writeMPUFIFO(LSST::cRIO::MPU& mpu) override {}
+    void readMPUFIFO(LSST::cRIO::MPU& mpu) override {}
+    void writeCommandFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
+    void writeRequestFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
+    void readU16ResponseFIFO(uint16_t* data, size_t length, uint32_t timeout) override;
+    void waitOnIrqs(uint32_t irqs, uint32_t timeout, uint32_t* triggered = NULL) override {}
+    void ackIrqs(uint32_t irqs) override {}
+
+    // number of bus commands written into the command FIFO
+    unsigned int commandWrites;
+    // number of response reads (one per bus)
+    unsigned int transactions;
+    // number of response reads preceded by commands written to more than one bus
+    unsigned int parallelTransactions;
+
+    // transaction times reported by FPGA
+    std::vector<std::pair<uint64_t, uint64_t>> times;
+
+    // if true, replies are terminated with end of frame (0xA000) followed by end timestamp, as
+    // FPGA does. Otherwise only end timestamp follows reply data
+    bool rxEndFrames;
+
+protected:
+    /**
+     * Simulates ILC command.
+     *
+     * @param bus bus the command was written to
+     * @param address ILC address
+     * @param func function code
+     * @param command command buffer, positioned after function code. Shall
+     * read function arguments and CRC
+     * @param response ILC response. Reply address, function and data shall
+     * be written, CRC and end of frame are added
+     *
+     * @return true if ILC replies to the command
+     */
+    virtual bool simulateCommand(uint8_t bus, uint8_t address, uint8_t func, LSST::cRIO::ILC& command,
+                                 LSST::cRIO::SimulatedILC& response) = 0;
+
+    /**
+     * Returns reply timestamp. Defaults to 0.
+     */
+    virtual uint64_t getRxTimestamp(uint8_t bus, uint8_t address) { return 0; }
+
+    void reportTime(uint64_t begin, uint64_t end) override { times.emplace_back(begin, end); }
+
+private:
+    LSST::cRIO::SimulatedILC _responses[6];
+    uint8_t _rxBus;
+    bool _readData;
+    std::set<uint8_t> _written;
+
+    void _simulate(uint8_t bus, uint16_t* data, size_t length);
+};
+
 #endif  //!__TEST_FPGA__
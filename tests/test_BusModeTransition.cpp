@@ -0,0 +1,250 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests bus-wide ILC mode transitions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <set>
+#include <string.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/BusModeTransition.h>
+#include <cRIO/SimulatedILC.h>
+
+#include <TestFPGA.h>
+
+using namespace LSST::cRIO;
+
+class ModeILC : public ILC {
+public:
+    ModeILC(uint8_t bus = 1) : ILC(bus) {}
+
+protected:
+    void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
+                         uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
+                         uint8_t minorRev, std::string firmwareName) override {}
+    void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override {}
+    void processChangeILCMode(uint8_t address, uint16_t mode) override {}
+    void processSetTempILCAddress(uint8_t address, uint8_t newAddress) override {}
+    void processResetServer(uint8_t address) override {}
+};
+
+/**
+ * Simulates FPGA with ILCs on multiple buses. ILCs reply to server status
+ * and mode change requests, and act on mode change broadcasts unless
+ * listed in ignoreBroadcast. ILCs listed in silent never reply. ClearFaults
+ * moves ILC into Standby.
+ */
+class ModeFPGA : public MultiBusFPGA {
+public:
+    // bus -> address -> ILC mode
+    std::map<uint8_t, std::map<uint8_t, uint8_t>> modes;
+    std::set<uint8_t> ignoreBroadcast;
+    std::set<uint8_t> silent;
+
+protected:
+    bool simulateCommand(uint8_t bus, uint8_t address, uint8_t func, ILC& command,
+                         SimulatedILC& response) override {
+        if (address == 250) {
+            REQUIRE(func == 65);
+            command.read<uint8_t>();
+            uint16_t mode = command.read<uint16_t>();
+            command.checkCRC();
+            for (auto& ilc : modes[bus]) {
+                if (ignoreBroadcast.count(ilc.first) == 0) {
+                    ilc.second = _newMode(mode);
+                }
+            }
+            return false;
+        }
+        switch (func) {
+            case 18:
+                command.checkCRC();
+                if (silent.count(address) > 0) {
+                    return false;
+                }
+                response.write(address);
+                response.write(func);
+                response.write(modes[bus][address]);
+                response.write<uint16_t>(0);
+                response.write<uint16_t>(0);
+                return true;
+            case 65: {
+                uint16_t mode = command.read<uint16_t>();
+                command.checkCRC();
+                if (silent.count(address) > 0) {
+                    return false;
+                }
+                modes[bus][address] = _newMode(mode);
+                response.write(address);
+                response.write(func);
+                response.write<uint16_t>(modes[bus][address]);
+                return true;
+            }
+            default:
+                FAIL("Unexpected function " << +func);
+        }
+        return false;
+    }
+
+private:
+    uint8_t _newMode(uint16_t mode) { return mode == ILC::ClearFaults ? ILC::Standby : mode; }
+};
+
+TEST_CASE("Next transition mode", "[BusModeTransition]") {
+    REQUIRE(BusModeTransition::nextMode(ILC::Standby, ILC::Enabled) == ILC::Disabled);
+    REQUIRE(BusModeTransition::nextMode(ILC::Disabled, ILC::Enabled) == ILC::Enabled);
+    REQUIRE(BusModeTransition::nextMode(ILC::Enabled, ILC::Standby) == ILC::Disabled);
+    REQUIRE(BusModeTransition::nextMode(ILC::Standby, ILC::FirmwareUpdate) == ILC::FirmwareUpdate);
+    REQUIRE(BusModeTransition::nextMode(ILC::Fault, ILC::ClearFaults) == ILC::ClearFaults);
+    REQUIRE(BusModeTransition::nextMode(ILC::Fault, ILC::Standby) == ILC::ClearFaults);
+    REQUIRE(BusModeTransition::nextMode(ILC::Fault, ILC::Enabled) == ILC::ClearFaults);
+    REQUIRE(BusModeTransition::nextMode(ILC::Fault, ILC::Fault) == ILC::Fault);
+}
+
+TEST_CASE("Broadcast mode transition", "[BusModeTransition]") {
+    ModeFPGA fpga;
+    ModeILC busA(1), busB(2);
+
+    std::vector<uint8_t> addressesA, addressesB;
+    for (uint8_t address = 1; address <= 30; address++) {
+        fpga.modes[1][address] = ILC::Standby;
+        addressesA.push_back(address);
+    }
+    for (uint8_t address = 1; address <= 4; address++) {
+        fpga.modes[2][address] = ILC::Standby;
+        addressesB.push_back(address);
+    }
+
+    BusModeTransition transition(&fpga);
+    transition.addBus(&busA, addressesA, true);
+    transition.addBus(&busB, addressesB);
+
+    transition.transition(ILC::Enabled);
+
+    for (auto address : addressesA) {
+        REQUIRE(fpga.modes[1][address] == ILC::Enabled);
+        REQUIRE(busA.getLastMode(address) == ILC::Enabled);
+    }
+    for (auto address : addressesB) {
+        REQUIRE(fpga.modes[2][address] == ILC::Enabled);
+    }
+
+    // status query, two broadcast and verify steps
+    REQUIRE(transition.getStatistics().transactions == 3);
+    REQUIRE(transition.getStatistics().broadcasts == 2);
+    // bus B isn't broadcasting
+    REQUIRE(transition.getStatistics().unicasts == 2 * 4);
+
+    SECTION("Unicast fallback") {
+        fpga.ignoreBroadcast = {7, 12};
+
+        transition.transition(ILC::Standby);
+
+        for (auto address : addressesA) {
+            REQUIRE(fpga.modes[1][address] == ILC::Standby);
+        }
+
+        REQUIRE(transition.getStatistics().transactions == 5);
+        REQUIRE(transition.getStatistics().broadcasts == 2);
+        REQUIRE(transition.getStatistics().unicasts == 2 * 4 + 2 * 2);
+    }
+
+    SECTION("ILCs in different modes") {
+        fpga.modes[1][5] = ILC::Disabled;
+
+        transition.transition(ILC::Standby);
+
+        for (auto address : addressesA) {
+            REQUIRE(fpga.modes[1][address] == ILC::Standby);
+        }
+
+        // the first step is commanded with unicasts, the second with broadcast
+        REQUIRE(transition.getStatistics().broadcasts == 1);
+        REQUIRE(transition.getStatistics().unicasts == 30 + 2 * 4);
+
+        fpga.modes[1][5] = ILC::Disabled;
+        fpga.modes[1][6] = ILC::Enabled;
+
+        transition.transition(ILC::Enabled);
+        REQUIRE(fpga.modes[1][5] == ILC::Enabled);
+        // ILCs already in the target mode don't prevent broadcast of the last step
+        REQUIRE(transition.getStatistics().broadcasts == 1);
+    }
+
+    SECTION("Failed transition") {
+        fpga.ignoreBroadcast = {3};
+
+        REQUIRE_THROWS_AS(transition.transition(ILC::Standby, 1), std::runtime_error);
+        REQUIRE(fpga.modes[1][3] == ILC::Disabled);
+    }
+}
+
+TEST_CASE("Mode transition from fault and of silent ILCs", "[BusModeTransition]") {
+    ModeFPGA fpga;
+    ModeILC busA(1), busB(2);
+
+    std::vector<uint8_t> addressesA, addressesB;
+    for (uint8_t address = 1; address <= 8; address++) {
+        fpga.modes[1][address] = ILC::Standby;
+        fpga.modes[2][address] = ILC::Standby;
+        addressesA.push_back(address);
+        addressesB.push_back(address);
+    }
+    fpga.modes[1][3] = ILC::Fault;
+    fpga.modes[2][5] = ILC::Fault;
+
+    BusModeTransition transition(&fpga);
+    transition.addBus(&busA, addressesA, true);
+    transition.addBus(&busB, addressesB);
+
+    SECTION("Clear faults") {
+        transition.transition(ILC::Enabled);
+
+        for (uint8_t address = 1; address <= 8; address++) {
+            REQUIRE(fpga.modes[1][address] == ILC::Enabled);
+            REQUIRE(fpga.modes[2][address] == ILC::Enabled);
+        }
+    }
+
+    SECTION("Silent ILC") {
+        fpga.silent = {4};
+        busA.setTolerateMissing(true);
+        busB.setTolerateMissing(true);
+
+        try {
+            transition.transition(ILC::Enabled);
+            FAIL("Transition shall fail");
+        } catch (std::runtime_error& e) {
+            REQUIRE(std::string(e.what()) ==
+                    "ILCs didn't reach mode 2 in 8 steps: 1:4 (no reply) 2:4 (no reply)");
+        }
+
+        // other ILCs were transitioned
+        for (uint8_t address = 1; address <= 8; address++) {
+            if (address == 4) {
+                continue;
+            }
+            REQUIRE(fpga.modes[1][address] == ILC::Enabled);
+            REQUIRE(fpga.modes[2][address] == ILC::Enabled);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests bus time budget planner.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/BusPlanner.h>
+
+using namespace LSST::cRIO;
+using namespace std::chrono_literals;
+
+TEST_CASE("Wire time estimates", "[BusPlanner]") {
+    BusPlanner planner(1000000, 20ms);
+
+    // 10 us per byte; 4 + 3.5 + 9 + 3.5 = 20 bytes + 270 us timeout
+    REQUIRE(planner.estimate(18) == 470us);
+
+    // double axis force demand; 11 + 3.5 + 13 + 3.5 = 31 bytes + 1800 us timeout
+    REQUIRE(planner.estimate(75) == 2110us);
+
+    REQUIRE_THROWS_AS(planner.estimate(200), std::out_of_range);
+
+    // broadcast
+    planner.setFunctionTiming(200, 50, 0, 150);
+    REQUIRE(planner.estimate(200) == 685us);
+}
+
+TEST_CASE("Admit calls within budget", "[BusPlanner]") {
+    BusPlanner planner(1000000, 2ms);
+
+    std::vector<int> calls;
+
+    REQUIRE_THROWS_AS(planner.queue(0, 107, nullptr), std::out_of_range);
+
+    // 4 x 470 us fit into 2 ms cycle
+    for (int i = 0; i < 3; i++) {
+        planner.queue(0, 18, [&calls, i]() { calls.push_back(i); });
+    }
+    for (int i = 10; i < 13; i++) {
+        planner.queue(5, 18, [&calls, i]() { calls.push_back(i); });
+    }
+
+    REQUIRE(planner.getBacklog() == 6);
+
+    REQUIRE(planner.planCycle() == 4 * 470us);
+    REQUIRE(calls == std::vector<int>({10, 11, 12, 0}));
+
+    auto stats = planner.getStatistics();
+    REQUIRE(stats.cycles == 1);
+    REQUIRE(stats.admitted == 4);
+    REQUIRE(stats.deferrals == 2);
+    REQUIRE(stats.deferredCycles == 1);
+    REQUIRE(stats.maxBacklog == 2);
+    REQUIRE(stats.maxPlanned == 4 * 470us);
+
+    // high priority call queued later is admitted before deferred calls
+    planner.queue(5, 18, [&calls]() { calls.push_back(13); });
+
+    calls.clear();
+    REQUIRE(planner.planCycle() == 3 * 470us);
+    REQUIRE(calls == std::vector<int>({13, 1, 2}));
+
+    stats = planner.getStatistics();
+    REQUIRE(stats.cycles == 2);
+    REQUIRE(stats.admitted == 7);
+    REQUIRE(stats.deferrals == 2);
+    REQUIRE(stats.deferredCycles == 1);
+
+    REQUIRE(planner.planCycle() == 0ns);
+
+    planner.resetStatistics();
+    REQUIRE(planner.getStatistics().cycles == 0);
+}
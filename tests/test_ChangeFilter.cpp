@@ -0,0 +1,95 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests ChangeFilter class.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/ChangeFilter.h>
+
+using namespace LSST::cRIO;
+using namespace std::chrono_literals;
+
+TEST_CASE("Absolute and relative deadbands", "[ChangeFilter]") {
+    ChangeFilter filter;
+
+    filter.setDeadband(1, 0.5);
+    filter.setDeadband(2, 0.1, true);
+
+    auto now = std::chrono::steady_clock::now();
+
+    double values[3] = {1, 10, 100};
+
+    REQUIRE(filter.changed(1, values, 3, now) == true);
+    REQUIRE(filter.changed(1, values, 3, now) == false);
+
+    // other address has its own history
+    REQUIRE(filter.changed(2, values, 3, now) == true);
+
+    // no deadband for the first field
+    values[0] = 1.001;
+    REQUIRE(filter.changed(1, values, 3, now) == true);
+
+    values[1] = 10.5;
+    REQUIRE(filter.changed(1, values, 3, now) == false);
+
+    values[1] = 10.6;
+    REQUIRE(filter.changed(1, values, 3, now) == true);
+
+    // deadband is calculated from the last published value
+    values[1] = 10.2;
+    REQUIRE(filter.changed(1, values, 3, now) == false);
+
+    values[2] = 109;
+    REQUIRE(filter.changed(1, values, 3, now) == false);
+
+    values[2] = 89;
+    REQUIRE(filter.changed(1, values, 3, now) == true);
+
+    values[2] = NAN;
+    REQUIRE(filter.changed(1, values, 3, now) == true);
+    REQUIRE(filter.changed(1, values, 3, now) == false);
+}
+
+TEST_CASE("Publish intervals", "[ChangeFilter]") {
+    ChangeFilter filter;
+
+    filter.setDeadband(0, 1);
+    filter.setPublishIntervals(100ms, 1s);
+
+    auto now = std::chrono::steady_clock::now();
+
+    double value = 10;
+
+    REQUIRE(filter.changed(11, &value, 1, now) == true);
+
+    value = 20;
+    REQUIRE(filter.changed(11, &value, 1, now + 50ms) == false);
+    REQUIRE(filter.changed(11, &value, 1, now + 100ms) == true);
+
+    REQUIRE(filter.changed(11, &value, 1, now + 500ms) == false);
+    REQUIRE(filter.changed(11, &value, 1, now + 1099ms) == false);
+
+    // heartbeat
+    REQUIRE(filter.changed(11, &value, 1, now + 1100ms) == true);
+    REQUIRE(filter.changed(11, &value, 1, now + 1200ms) == false);
+}
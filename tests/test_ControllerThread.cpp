@@ -20,6 +20,11 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include <cRIO/Command.h>
@@ -28,7 +33,7 @@
 using namespace LSST::cRIO;
 using namespace std::chrono_literals;
 
-int tv;
+std::atomic<int> tv;
 
 class TestCommand : public Command {
 public:
@@ -73,3 +78,178 @@ TEST_CASE("Queue to controller before run", "[ControllerThread]") {
 
     REQUIRE(tv == 10);
 }
+
+TEST_CASE("Enqueue from multiple threads", "[ControllerThread]") {
+    tv = 0;
+
+    ControllerThread::instance().start();
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+        producers.emplace_back([] {
+            for (int i = 0; i < 1000; i++) {
+                ControllerThread::instance().enqueue(new TestCommand());
+            }
+        });
+    }
+
+    for (auto& p : producers) {
+        p.join();
+    }
+
+    for (int i = 0; i < 100 && tv < 4000; i++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ControllerThread::instance().stop();
+
+    REQUIRE(tv == 4000);
+}
+
+std::atomic<bool> blockedRunning;
+std::atomic<bool> blockedRelease;
+
+class BlockingCommand : public Command {
+public:
+    void execute() override {
+        blockedRunning = true;
+        while (blockedRelease == false) {
+            std::this_thread::sleep_for(1ms);
+        }
+        tv++;
+    }
+};
+
+TEST_CASE("Enqueue while command executes", "[ControllerThread]") {
+    tv = 0;
+    blockedRunning = false;
+    blockedRelease = false;
+
+    ControllerThread::instance().start();
+
+    ControllerThread::instance().enqueue(new BlockingCommand());
+
+    while (blockedRunning == false) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    // doesn't block, as command is executed without lock
+    for (int i = 0; i < 10; i++) {
+        ControllerThread::instance().enqueue(new TestCommand());
+    }
+
+    REQUIRE(tv == 0);
+
+    blockedRelease = true;
+
+    for (int i = 0; i < 100 && tv < 11; i++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ControllerThread::instance().stop();
+
+    REQUIRE(tv == 11);
+}
+
+std::vector<int> executed;
+std::atomic<size_t> executedCount;
+std::vector<std::string> failed;
+
+class OrderCommand : public Command {
+public:
+    OrderCommand(int id, int priority) : Command(priority), _id(id) {}
+
+    void execute() override {
+        executed.push_back(_id);
+        executedCount++;
+        if (_id == 0) {
+            blockedRunning = true;
+            while (blockedRelease == false) {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+    }
+
+    void ackFailed(std::string reason) override { failed.push_back(std::to_string(_id) + ": " + reason); }
+
+private:
+    int _id;
+};
+
+TEST_CASE("Priority ordering", "[ControllerThread]") {
+    executed.clear();
+    executedCount = 0;
+
+    ControllerThread::instance().enqueue(new OrderCommand(1, Command::PRIORITY_HOUSEKEEPING));
+    ControllerThread::instance().enqueue(new OrderCommand(2, Command::PRIORITY_NORMAL));
+    ControllerThread::instance().enqueue(new OrderCommand(3, Command::PRIORITY_URGENT));
+    ControllerThread::instance().enqueue(new OrderCommand(4, Command::PRIORITY_NORMAL));
+    ControllerThread::instance().enqueue(new OrderCommand(5, Command::PRIORITY_URGENT));
+    ControllerThread::instance().enqueue(new OrderCommand(6, Command::PRIORITY_HOUSEKEEPING));
+
+    ControllerThread::instance().start();
+
+    for (int i = 0; i < 100 && executedCount < 6; i++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ControllerThread::instance().stop();
+
+    REQUIRE(executed == std::vector<int>({3, 5, 2, 4, 1, 6}));
+}
+
+TEST_CASE("Urgent command overtakes queued commands", "[ControllerThread]") {
+    executed.clear();
+    executedCount = 0;
+    blockedRunning = false;
+    blockedRelease = false;
+
+    ControllerThread::instance().start();
+
+    ControllerThread::instance().enqueue(new OrderCommand(0, Command::PRIORITY_NORMAL));
+
+    while (blockedRunning == false) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    ControllerThread::instance().enqueue(new OrderCommand(1, Command::PRIORITY_HOUSEKEEPING));
+    ControllerThread::instance().enqueue(new OrderCommand(2, Command::PRIORITY_NORMAL));
+    ControllerThread::instance().enqueue(new OrderCommand(3, Command::PRIORITY_URGENT));
+
+    blockedRelease = true;
+
+    for (int i = 0; i < 100 && executedCount < 4; i++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ControllerThread::instance().stop();
+
+    REQUIRE(executed == std::vector<int>({0, 3, 2, 1}));
+}
+
+TEST_CASE("Expired commands aren't executed", "[ControllerThread]") {
+    executed.clear();
+    executedCount = 0;
+    failed.clear();
+
+    auto expired = new OrderCommand(1, Command::PRIORITY_NORMAL);
+    expired->setDeadline(std::chrono::steady_clock::now() - 1ms);
+    ControllerThread::instance().enqueue(expired);
+
+    auto valid = new OrderCommand(2, Command::PRIORITY_NORMAL);
+    valid->setTimeout(10s);
+    ControllerThread::instance().enqueue(valid);
+
+    ControllerThread::instance().enqueue(new OrderCommand(3, Command::PRIORITY_NORMAL));
+
+    ControllerThread::instance().start();
+
+    for (int i = 0; i < 100 && executedCount < 2; i++) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ControllerThread::instance().stop();
+
+    REQUIRE(executed == std::vector<int>({2, 3}));
+    REQUIRE(failed == std::vector<std::string>({"1: Command deadline expired"}));
+}
@@ -0,0 +1,187 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests ILC discovery.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <set>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/Discovery.h>
+#include <cRIO/SimulatedILC.h>
+
+#include <TestFPGA.h>
+
+using namespace LSST::cRIO;
+
+class ParserILC : public ILC {
+public:
+    ParserILC() : ILC(1) {}
+
+protected:
+    void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
+                         uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
+                         uint8_t minorRev, std::string firmwareName) override {}
+    void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override {}
+    void processChangeILCMode(uint8_t address, uint16_t mode) override {}
+    void processSetTempILCAddress(uint8_t address, uint8_t newAddress) override {}
+    void processResetServer(uint8_t address) override {}
+};
+
+/**
+ * Simulates FPGA with ILCs on multiple buses. ILCs reply to server ID
+ * requests only on populated addresses.
+ */
+class DiscoveryFPGA : public MultiBusFPGA {
+public:
+    std::map<uint8_t, std::set<uint8_t>> populated;
+    // buses replying with corrupted server ID
+    std::set<uint8_t> corrupted;
+
+protected:
+    bool simulateCommand(uint8_t bus, uint8_t address, uint8_t func, ILC& command,
+                         SimulatedILC& response) override {
+        REQUIRE(func == 17);
+        command.checkCRC();
+        if (populated[bus].count(address) == 0) {
+            return false;
+        }
+        response.write(address);
+        response.write(func);
+        if (corrupted.count(bus) > 0) {
+            // invalid response length
+            response.write<uint8_t>(2);
+            return true;
+        }
+        response.write<uint8_t>(14);
+        response.write<uint16_t>(bus);
+        response.write<uint32_t>(address);
+        for (uint8_t i = 0; i < 6; i++) {
+            response.write(i);
+        }
+        response.write<uint8_t>('F');
+        response.write<uint8_t>('W');
+        return true;
+    }
+
+    uint64_t getRxTimestamp(uint8_t bus, uint8_t address) override {
+        return 0x0102030405060000 + address * 1000;
+    }
+};
+
+TEST_CASE("Discover ILCs on multiple buses", "[Discovery]") {
+    DiscoveryFPGA fpga;
+
+    fpga.populated[1] = {1, 17, 48};
+    fpga.populated[2] = {247};
+    fpga.populated[5] = {64, 65, 128};
+
+    Discovery discovery(&fpga, {1, 2, 3, 4, 5});
+
+    auto found = discovery.scan();
+
+    // 247 addresses in batches of 64
+    REQUIRE(fpga.commandWrites == 4 * 5);
+
+    REQUIRE(found.size() == 7);
+
+    std::vector<std::pair<uint8_t, uint8_t>> expected = {{1, 1},  {1, 17}, {1, 48}, {2, 247},
+                                                         {5, 64}, {5, 65}, {5, 128}};
+    for (size_t i = 0; i < expected.size(); i++) {
+        REQUIRE(found[i].bus == expected[i].first);
+        REQUIRE(found[i].address == expected[i].second);
+        REQUIRE(found[i].uniqueID == (static_cast<uint64_t>(expected[i].first) << 32 | expected[i].second));
+        REQUIRE(found[i].ilcAppType == 0);
+        REQUIRE(found[i].minorRev == 5);
+        REQUIRE(found[i].firmwareName == "FW");
+    }
+
+    fpga.commandWrites = 0;
+    discovery.setBatchSize(10);
+    found = discovery.scan(60, 70);
+    REQUIRE(fpga.commandWrites == 2 * 5);
+    REQUIRE(found.size() == 2);
+    REQUIRE(found[0].address == 64);
+    REQUIRE(found[1].address == 65);
+}
+
+TEST_CASE("Continue scan after bus failure", "[Discovery]") {
+    DiscoveryFPGA fpga;
+
+    fpga.populated[1] = {1, 100};
+    fpga.populated[2] = {5};
+    fpga.populated[3] = {200};
+
+    fpga.corrupted = {2};
+
+    Discovery discovery(&fpga, {1, 2, 3});
+
+    auto found = discovery.scan();
+
+    REQUIRE(found.size() == 3);
+    REQUIRE(found[0].bus == 1);
+    REQUIRE(found[0].address == 1);
+    REQUIRE(found[1].bus == 1);
+    REQUIRE(found[1].address == 100);
+    REQUIRE(found[2].bus == 3);
+    REQUIRE(found[2].address == 200);
+
+    REQUIRE(discovery.getErrors().size() == 1);
+    REQUIRE(discovery.getErrors().count(2) == 1);
+
+    // bus 2 isn't scanned after failure in the first batch
+    REQUIRE(fpga.commandWrites == 4 + 1 + 4);
+
+    fpga.corrupted.clear();
+    found = discovery.scan();
+    REQUIRE(found.size() == 4);
+    REQUIRE(discovery.getErrors().empty());
+}
+
+TEST_CASE("Tolerate missing replies", "[Discovery]") {
+    DiscoveryFPGA fpga;
+
+    ParserILC ilc;
+
+    ilc.reportServerID(1);
+    ilc.reportServerID(2);
+
+    fpga.populated[1] = {2};
+
+    REQUIRE_THROWS_AS(fpga.ilcCommands(ilc), ModbusBuffer::UnmatchedFunction);
+
+    ilc.clear();
+    ilc.setTolerateMissing(true);
+
+    ilc.reportServerID(1);
+    ilc.reportServerID(2);
+    ilc.reportServerID(3);
+
+    fpga.times.clear();
+
+    REQUIRE_NOTHROW(fpga.ilcCommands(ilc));
+
+    // reply time, and the rest of the transaction
+    REQUIRE(fpga.times.size() == 2);
+    REQUIRE(fpga.times[0].first == 0);
+    REQUIRE(fpga.times[0].second == 0x0102030405060000 + 2000);
+    REQUIRE(fpga.times[1].first == 0x0102030405060000 + 2000);
+}
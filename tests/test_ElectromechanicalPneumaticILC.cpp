@@ -43,6 +43,14 @@ public:
         set_nan(responseBackupADCK);
         set_nan(responseBackupOffset);
         set_nan(responseBackupSensitivity);
+
+        hardpointForceStatusCallCounter = 0;
+        lvdtCallCounter = 0;
+        lvdtsCallCounter = 0;
+        for (int i = 0; i < HP_COUNT; i++) {
+            responseBreakawayLVDTs[i] = 0;
+            responseDisplacementLVDTs[i] = 0;
+        }
     }
 
     float responseMainADCK[4];
@@ -52,6 +60,18 @@ public:
     float responseBackupOffset[4];
     float responseBackupSensitivity[4];
 
+    unsigned int hardpointForceStatusCallCounter;
+    uint8_t responseStatus;
+    int32_t responseEncoderPosition;
+    float responseLoadCellForce;
+
+    unsigned int lvdtCallCounter;
+    float responseBreakawayLVDT, responseDisplacementLVDT;
+
+    unsigned int lvdtsCallCounter;
+    float responseBreakawayLVDTs[HP_COUNT];
+    float responseDisplacementLVDTs[HP_COUNT];
+
 protected:
     void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
                          uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
@@ -66,7 +86,12 @@ protected:
     void processResetServer(uint8_t address) override {}
 
     void processHardpointForceStatus(uint8_t address, uint8_t status, int32_t encoderPosition,
-                                     float loadCellForce) override {}
+                                     float loadCellForce) override {
+        hardpointForceStatusCallCounter++;
+        responseStatus = status;
+        responseEncoderPosition = encoderPosition;
+        responseLoadCellForce = loadCellForce;
+    }
 
     void processCalibrationData(uint8_t address, float mainADCK[4], float mainOffset[4],
                                 float mainSensitivity[4], float backupADCK[4], float backupOffset[4],
@@ -82,6 +107,19 @@ protected:
 
     void processMezzaninePressure(uint8_t address, float primaryPush, float primaryPull, float secondaryPush,
                                   float secondaryPull) override;
+
+    void processHardpointLVDT(uint8_t address, float breakawayLVDT, float displacementLVDT) override {
+        lvdtCallCounter++;
+        responseBreakawayLVDT = breakawayLVDT;
+        responseDisplacementLVDT = displacementLVDT;
+    }
+
+    void processHardpointLVDTs(const float breakawayLVDT[HP_COUNT],
+                               const float displacementLVDT[HP_COUNT]) override {
+        lvdtsCallCounter++;
+        memcpy(responseBreakawayLVDTs, breakawayLVDT, sizeof(responseBreakawayLVDTs));
+        memcpy(responseDisplacementLVDTs, displacementLVDT, sizeof(responseDisplacementLVDTs));
+    }
 };
 
 void TestElectromechanicalPneumaticILC::processMezzaninePressure(uint8_t address, float primaryPush,
@@ -182,3 +220,100 @@ TEST_CASE("Test parsing of pressure data", "[ElectromechaniclPneumaticILC]") {
 
     REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
 }
+
+TEST_CASE("Test step motor move", "[ElectromechaniclPneumaticILC]") {
+    TestElectromechanicalPneumaticILC ilc, response;
+
+    ilc.setStepperSteps(87, -45);
+
+    int8_t steps[HP_COUNT] = {1, -2, 3, -100, 100, 0};
+    ilc.broadcastStepperSteps(steps);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 87);
+    REQUIRE(ilc.read<uint8_t>() == 66);
+    REQUIRE(ilc.read<int8_t>() == -45);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 1800);
+
+    REQUIRE(ilc.read<uint8_t>() == 249);
+    REQUIRE(ilc.read<uint8_t>() == 66);
+    REQUIRE(ilc.read<uint8_t>() == 1);
+    for (int i = 0; i < HP_COUNT; i++) {
+        REQUIRE(ilc.read<int8_t>() == steps[i]);
+    }
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readDelay() == 150);
+
+    response.write<uint8_t>(87);
+    response.write<uint8_t>(66);
+    response.write<uint8_t>(0x08);
+    response.write<int32_t>(-123456);
+    response.write<float>(-34.56f);
+    response.writeCRC();
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    REQUIRE(ilc.hardpointForceStatusCallCounter == 1);
+    REQUIRE(ilc.responseStatus == 0x08);
+    REQUIRE(ilc.responseEncoderPosition == -123456);
+    REQUIRE(ilc.responseLoadCellForce == -34.56f);
+}
+
+TEST_CASE("Test parsing of LVDT data", "[ElectromechaniclPneumaticILC]") {
+    TestElectromechanicalPneumaticILC ilc, response;
+
+    REQUIRE_THROWS_AS(ilc.setHardpoint(0, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(ilc.setHardpoint(84, HP_COUNT), std::out_of_range);
+
+    ilc.setHardpoint(84, 0);
+    ilc.setHardpoint(89, 5);
+
+    ilc.reportLVDT(84);
+    ilc.reportLVDT(89);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 84);
+    REQUIRE(ilc.read<uint8_t>() == 122);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 1800);
+
+    auto addResponse = [&response](uint8_t address, float breakaway, float displacement) {
+        response.write<uint8_t>(address);
+        response.write<uint8_t>(122);
+        response.write<float>(breakaway);
+        response.write<float>(displacement);
+        response.writeCRC();
+    };
+
+    addResponse(84, 1.234f, -5.678f);
+    addResponse(89, 0.5f, 0.25f);
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    REQUIRE(ilc.lvdtCallCounter == 2);
+    REQUIRE(ilc.responseBreakawayLVDT == 0.5f);
+    REQUIRE(ilc.responseDisplacementLVDT == 0.25f);
+
+    REQUIRE(ilc.lvdtsCallCounter == 0);
+
+    ilc.endOfCycle();
+
+    REQUIRE(ilc.lvdtsCallCounter == 1);
+    REQUIRE(ilc.responseBreakawayLVDTs[0] == 1.234f);
+    REQUIRE(ilc.responseDisplacementLVDTs[0] == -5.678f);
+    REQUIRE(ilc.responseBreakawayLVDTs[5] == 0.5f);
+    REQUIRE(ilc.responseDisplacementLVDTs[5] == 0.25f);
+    for (int i = 1; i < 5; i++) {
+        REQUIRE(std::isnan(ilc.responseBreakawayLVDTs[i]));
+        REQUIRE(std::isnan(ilc.responseDisplacementLVDTs[i]));
+    }
+
+    ilc.endOfCycle();
+    REQUIRE(ilc.lvdtsCallCounter == 1);
+}
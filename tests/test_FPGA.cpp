@@ -0,0 +1,88 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests FPGA ILC commands.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/FPGA.h>
+#include <cRIO/SimulatedILC.h>
+
+#include <TestFPGA.h>
+
+using namespace LSST::cRIO;
+
+/**
+ * ILCs reply to server status requests 150 us after transaction start.
+ */
+class StatusFPGA : public MultiBusFPGA {
+protected:
+    bool simulateCommand(uint8_t bus, uint8_t address, uint8_t func, ILC& command,
+                         SimulatedILC& response) override {
+        REQUIRE(func == 18);
+        command.checkCRC();
+        response.write(address);
+        response.write(func);
+        response.write<uint8_t>(ILC::Standby);
+        response.write<uint16_t>(0);
+        response.write<uint16_t>(0);
+        return true;
+    }
+
+    uint64_t getRxTimestamp(uint8_t bus, uint8_t address) override { return 150000; }
+};
+
+TEST_CASE("Response times", "[FPGA]") {
+    StatusFPGA fpga;
+    TestILC ilc(1);
+
+    auto readTimeout = [&ilc]() {
+        ilc.clear();
+        ilc.reportServerStatus(5);
+        ilc.reset();
+        REQUIRE(ilc.read<uint8_t>() == 5);
+        REQUIRE(ilc.read<uint8_t>() == 18);
+        REQUIRE_NOTHROW(ilc.checkCRC());
+        REQUIRE_NOTHROW(ilc.readEndOfFrame());
+        return ilc.readWaitForRx();
+    };
+
+    ilc.setLearnedTimeouts(true, 100, 1000, 1, 50);
+
+    SECTION("Timestamp after reply data") { fpga.rxEndFrames = false; }
+
+    SECTION("End of frame before timestamp") { fpga.rxEndFrames = true; }
+
+    for (int i = 0; i < 8; i++) {
+        ilc.clear();
+        ilc.reportServerStatus(5);
+        REQUIRE_NOTHROW(fpga.ilcCommands(ilc));
+    }
+
+    REQUIRE(ilc.getLastMode(5) == ILC::Standby);
+
+    // reply time, and the rest of the transaction
+    REQUIRE(fpga.times.size() == 2 * 8);
+    REQUIRE(fpga.times[0] == std::make_pair<uint64_t, uint64_t>(0, 150000));
+    REQUIRE(fpga.times[1] == std::make_pair<uint64_t, uint64_t>(150000, 0));
+
+    // 150 us response time + 50 us margin
+    REQUIRE(readTimeout() == 200);
+}
@@ -194,3 +194,22 @@ TEST_CASE("Tests multiple disable/enable", "[FPGACliApp]") {
     REQUIRE(testRuns == 4);
     REQUIRE(disabledCount == 0);
 }
+
+TEST_CASE("Program pages per transaction", "[FPGACliApp]") {
+    AClass cli("name", "description");
+
+    REQUIRE(cli.processCmdVector({"@program-pages"}) == 0);
+    REQUIRE(cli.processCmdVector({"@program-pages", "8"}) == 0);
+    REQUIRE(cli.processCmdVector({"@program-pages", "0"}) == -1);
+    REQUIRE(cli.processCmdVector({"@program-pages", "a"}) == -1);
+}
+
+TEST_CASE("Program target firmware", "[FPGACliApp]") {
+    AClass cli("name", "description");
+
+    REQUIRE(cli.processCmdVector({"@program-target"}) == 0);
+    REQUIRE(cli.processCmdVector({"@program-target", "FW", "1", "2"}) == 0);
+    REQUIRE(cli.processCmdVector({"@program-target", "FW", "1"}) == -1);
+    REQUIRE(cli.processCmdVector({"@program-force", "on"}) == 0);
+    REQUIRE(cli.processCmdVector({"@program-force", "a"}) == -1);
+}
@@ -24,6 +24,7 @@
 #include <cmath>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <cRIO/ILC.h>
 
@@ -141,6 +142,41 @@ TEST_CASE("Generic functions", "[ILC]") {
     REQUIRE(ilc.readWaitForRx() == 87000);
 }
 
+TEST_CASE("Freeze sensor values", "[ILC]") {
+    TestILC ilc;
+
+    ilc.startCycle();
+    REQUIRE(ilc.getLength() == 0);
+
+    ilc.broadcastFreezeSensorValues(249, 300);
+
+    ilc.setFreezeCycle(true);
+    ilc.startCycle();
+    ilc.reportServerStatus(12);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 249);
+    REQUIRE(ilc.read<uint8_t>() == 68);
+    REQUIRE(ilc.read<uint8_t>() == 1);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readDelay() == 300);
+
+    REQUIRE(ilc.read<uint8_t>() == 248);
+    REQUIRE(ilc.read<uint8_t>() == 68);
+    REQUIRE(ilc.read<uint8_t>() == 2);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readDelay() == 450);
+
+    REQUIRE(ilc.read<uint8_t>() == 12);
+    REQUIRE(ilc.read<uint8_t>() == 18);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 270);
+}
+
 TEST_CASE("CalculateCRC", "[ILC]") {
     TestILC ilc;
     // address
@@ -348,6 +384,188 @@ TEST_CASE("Change ILC mode response", "[ILC]") {
     REQUIRE(ilc1.newMode == 4);
 }
 
+TEST_CASE("ADC scan rate and readout scheduling", "[ILC]") {
+    TestILC ilc, response;
+
+    REQUIRE_THROWS_AS(ilc.setADCScanRate(18, 16), std::out_of_range);
+    REQUIRE(ILC::getADCSampleRate(15) == 2.5);
+
+    ilc.setADCScanRate(18, 5);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 18);
+    REQUIRE(ilc.read<uint8_t>() == 80);
+    REQUIRE(ilc.read<uint8_t>() == 5);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 335);
+
+    auto now = std::chrono::steady_clock::now();
+
+    // rate not yet confirmed - readout is always due
+    REQUIRE(ilc.getSampleLatency(18) == std::chrono::nanoseconds::zero());
+    REQUIRE(ilc.readoutDue(18, now) == true);
+    REQUIRE(ilc.readoutDue(18, now) == true);
+
+    response.write<uint8_t>(18);
+    response.write<uint8_t>(80);
+    response.write<uint8_t>(5);
+    response.writeCRC();
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    REQUIRE(ilc.getSampleLatency(18) == std::chrono::milliseconds(1));
+
+    REQUIRE(ilc.readoutDue(18, now + std::chrono::microseconds(500)) == false);
+    REQUIRE(ilc.readoutDue(18, now + std::chrono::microseconds(1000)) == true);
+    REQUIRE(ilc.readoutDue(18, now + std::chrono::microseconds(1500)) == false);
+    REQUIRE(ilc.readoutDue(18, now + std::chrono::microseconds(2000)) == true);
+
+    REQUIRE(ilc.readoutDue(19, now) == true);
+}
+
+TEST_CASE("Learned timeouts", "[ILC]") {
+    TestILC ilc, response;
+
+    auto readTimeout = [&ilc](uint8_t address) {
+        ilc.clear();
+        ilc.reportServerStatus(address);
+        ilc.reset();
+        REQUIRE(ilc.read<uint8_t>() == address);
+        REQUIRE(ilc.read<uint8_t>() == 18);
+        REQUIRE_NOTHROW(ilc.checkCRC());
+        REQUIRE_NOTHROW(ilc.readEndOfFrame());
+        return ilc.readWaitForRx();
+    };
+
+    auto respond = [&ilc, &response](uint64_t responseTime) {
+        ilc.clear();
+        ilc.reportServerStatus(12);
+        response.clear();
+        response.write<uint8_t>(12);
+        response.write<uint8_t>(18);
+        response.write<uint8_t>(0);
+        response.write<uint16_t>(0);
+        response.write<uint16_t>(0);
+        response.writeCRC();
+        REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+        ilc.reportResponseTime(1000000, 1000000 + responseTime);
+    };
+
+    ilc.setLearnedTimeouts(true, 100, 1000, 0.9, 50);
+
+    for (int i = 0; i < 7; i++) {
+        respond(150000);
+    }
+
+    // not enough data
+    REQUIRE(readTimeout(12) == 270);
+
+    respond(160000);
+
+    // 90th percentile of 8 responses is the maximum
+    REQUIRE(readTimeout(12) == 210);
+
+    for (int i = 0; i < 2; i++) {
+        respond(10000);
+    }
+
+    // 90th percentile of 10 responses is 9th
+    REQUIRE(readTimeout(12) == 200);
+
+    // floor
+    for (int i = 0; i < 32; i++) {
+        respond(10000);
+    }
+    REQUIRE(readTimeout(12) == 100);
+
+    // ceiling
+    for (int i = 0; i < 32; i++) {
+        respond(5000000);
+    }
+    REQUIRE(readTimeout(12) == 1000);
+
+    // other address uses default timeout
+    REQUIRE(readTimeout(13) == 270);
+
+    ilc.setLearnedTimeouts(false);
+    REQUIRE(readTimeout(12) == 270);
+}
+
+TEST_CASE("Learned timeouts of long calls and missed replies", "[ILC]") {
+    TestILC ilc, response;
+
+    auto readModeTimeout = [&ilc](uint16_t mode) {
+        ilc.clear();
+        ilc.changeILCMode(12, mode);
+        ilc.reset();
+        REQUIRE(ilc.read<uint8_t>() == 12);
+        REQUIRE(ilc.read<uint8_t>() == 65);
+        REQUIRE(ilc.read<uint16_t>() == mode);
+        REQUIRE_NOTHROW(ilc.checkCRC());
+        REQUIRE_NOTHROW(ilc.readEndOfFrame());
+        return ilc.readWaitForRx();
+    };
+
+    auto respond = [&ilc, &response](uint16_t mode, uint64_t responseTime) {
+        ilc.clear();
+        ilc.changeILCMode(12, mode);
+        response.clear();
+        response.write<uint8_t>(12);
+        response.write<uint8_t>(65);
+        response.write<uint16_t>(mode);
+        response.writeCRC();
+        REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+        ilc.reportResponseTime(1000000, 1000000 + responseTime);
+    };
+
+    ilc.setLearnedTimeouts(true, 100, 1000, 1, 50);
+
+    for (int i = 0; i < 4; i++) {
+        respond(ILC::Disabled, 150000);
+        respond(ILC::Standby, 150000);
+    }
+
+    REQUIRE(readModeTimeout(ILC::Disabled) == 200);
+
+    // Standby -> FirmwareUpdate requests longer timeout, learned separately. Long timeouts are
+    // written in ms, rounded up
+    REQUIRE(readModeTimeout(ILC::FirmwareUpdate) == 101000);
+
+    for (int i = 0; i < 4; i++) {
+        respond(ILC::FirmwareUpdate, 5000000);
+        respond(ILC::Standby, 5000000);
+    }
+
+    // requested timeout above ceiling isn't cut to the ceiling
+    REQUIRE(readModeTimeout(ILC::FirmwareUpdate) == 6000);
+    REQUIRE(readModeTimeout(ILC::Disabled) == 200);
+
+    REQUIRE(ilc.getResponseTimeouts(12, 65) == 0);
+
+    // missed reply widens the learned timeout
+    ilc.clear();
+    ilc.changeILCMode(12, ILC::Disabled);
+    REQUIRE_THROWS_AS(ilc.checkCommandedEmpty(), std::runtime_error);
+
+    REQUIRE(ilc.getResponseTimeouts(12, 65) == 1);
+    REQUIRE(readModeTimeout(ILC::Disabled) == 400);
+
+    ilc.clear();
+    ilc.changeILCMode(12, ILC::Disabled);
+    REQUIRE_THROWS_AS(ilc.checkCommandedEmpty(), std::runtime_error);
+
+    REQUIRE(ilc.getResponseTimeouts(12, 65) == 2);
+    REQUIRE(readModeTimeout(ILC::Disabled) == 800);
+
+    // received replies narrow it back
+    respond(ILC::Disabled, 150000);
+    REQUIRE(readModeTimeout(ILC::Disabled) == 500);
+    respond(ILC::Standby, 150000);
+    REQUIRE(readModeTimeout(ILC::Disabled) == 350);
+}
+
 TEST_CASE("Set Temp ILC Address", "[ILC]") {
     TestILC ilc1;
     TestILC ilc2;
@@ -563,6 +781,8 @@ TEST_CASE("Multiple calls to processResponse", "[ILC]") {
 TEST_CASE("Response cache management", "[ILC]") {
     TestILC ilc1, ilc2;
 
+    ilc1.setFullCompare(GENERATE(false, true));
+
     ilc1.reportServerID(18);
 
     auto constructResponse = [&ilc2](uint8_t address, uint8_t id1) {
@@ -20,6 +20,11 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include <cRIO/IntelHex.h>
@@ -53,3 +58,120 @@ TEST_CASE("load", "[IntelHex]") {
         REQUIRE(data[i] == hexData[i]);
     }
 }
+
+TEST_CASE("load from stream and buffer", "[IntelHex]") {
+    IntelHex file;
+    file.load("data/ILC-3.hex");
+
+    uint16_t fileStart;
+    std::vector<uint8_t> fileData = file.getData(fileStart);
+
+    REQUIRE(fileData.size() > 0);
+
+    std::ifstream input("data/ILC-3.hex");
+    std::stringstream content;
+    content << input.rdbuf();
+
+    IntelHex stream;
+    stream.load(content);
+
+    uint16_t streamStart;
+    REQUIRE(stream.getData(streamStart) == fileData);
+    REQUIRE(streamStart == fileStart);
+
+    // CRLF line endings
+    std::string crlf;
+    std::string line;
+    content.clear();
+    content.seekg(0);
+    while (std::getline(content, line)) {
+        crlf += line + "\r\n";
+    }
+
+    IntelHex buffer;
+    buffer.load(crlf.data(), crlf.size());
+
+    uint16_t bufferStart;
+    REQUIRE(buffer.getData(bufferStart) == fileData);
+    REQUIRE(bufferStart == fileStart);
+}
+
+TEST_CASE("load errors", "[IntelHex]") {
+    IntelHex hex;
+
+    auto loadError = [&hex](const char* text, size_t line, const char* message) {
+        try {
+            hex.load(text, strlen(text));
+            FAIL("LoadError not thrown");
+        } catch (LoadError& e) {
+            REQUIRE(e.getLine() == line);
+            REQUIRE(std::string(e.what()) == message);
+        }
+    };
+
+    loadError(":0400000002002300D7\n020000", 2, "Invalid start code '0' expecting ':'");
+    loadError(":0400000002002300D7\n:0400", 2,
+              "Unable to Parse ByteCount, Address, and RecordType for line.");
+    loadError(":0400000002002300D7\n:040004000200G300D7", 2, "Unable to parse DataByte 2");
+    loadError(":0400000002002300", 1, "Unable to parse Checksum");
+    loadError(":0400000002002300D6", 1, "Checksum mismatch, expecting 0xD6, got 0xD7");
+    loadError(":0100000401FA", 1, "Invalid extension size - expected 2, got 1");
+}
+
+TEST_CASE("unordered records", "[IntelHex]") {
+    auto record = [](uint16_t address, std::vector<uint8_t> data) {
+        std::vector<uint8_t> bytes = {static_cast<uint8_t>(data.size()), static_cast<uint8_t>(address >> 8),
+                                      static_cast<uint8_t>(address & 0xFF), 0};
+        bytes.insert(bytes.end(), data.begin(), data.end());
+        uint8_t sum = 0;
+        std::string ret = ":";
+        char buf[3];
+        for (auto b : bytes) {
+            sum += b;
+            snprintf(buf, sizeof(buf), "%02X", b);
+            ret += buf;
+        }
+        snprintf(buf, sizeof(buf), "%02X", static_cast<uint8_t>(-sum));
+        return ret + buf + "\n";
+    };
+
+    std::string text = record(0x0108, {0x31, 0x32, 0x33, 0x34}) + record(0x0100, {0x11, 0x12}) +
+                       record(0x0110, {0x41, 0x42}) + record(0x0102, {0x21, 0x22}) +
+                       record(0x010C, {0x35, 0x36});
+
+    IntelHex hex;
+    hex.load(text.data(), text.size());
+
+    std::vector<std::pair<uint32_t, uint32_t>> ranges = {
+            {0x0100, 0x0104}, {0x0108, 0x010E}, {0x0110, 0x0112}};
+    REQUIRE(hex.getRanges() == ranges);
+
+    uint16_t startAddress;
+    std::vector<uint8_t> data = hex.getData(startAddress);
+
+    REQUIRE(startAddress == 0x0100);
+    REQUIRE(data == std::vector<uint8_t>({0x11, 0x12, 0x21, 0x22, 0xFF, 0xFF, 0xFF, 0x00, 0x31, 0x32, 0x33,
+                                          0x34, 0x35, 0x36, 0xFF, 0x00, 0x41, 0x42}));
+
+    IntelHex::View view = hex.getView();
+    REQUIRE(view.startAddress == startAddress);
+    REQUIRE(std::vector<uint8_t>(view.data, view.data + view.length) == data);
+
+    // bridge all gaps
+    text += record(0x0104, {0x51, 0x52, 0x53, 0x54}) + record(0x010E, {0x61, 0x62});
+    hex.load(text.data(), text.size());
+
+    ranges = {{0x0100, 0x0112}};
+    REQUIRE(hex.getRanges() == ranges);
+
+    data = hex.getData(startAddress);
+    REQUIRE(startAddress == 0x0100);
+    REQUIRE(data == std::vector<uint8_t>({0x11, 0x12, 0x21, 0x22, 0x51, 0x52, 0x53, 0x54, 0x31, 0x32, 0x33,
+                                          0x34, 0x35, 0x36, 0x61, 0x62, 0x41, 0x42}));
+
+    // empty file
+    hex.load("", 0);
+    REQUIRE(hex.getRanges().empty());
+    REQUIRE(hex.getView().length == 0);
+    REQUIRE(hex.getData(startAddress).empty());
+}
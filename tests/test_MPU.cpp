@@ -24,6 +24,8 @@
 
 #include <cRIO/MPU.h>
 
+#include "TestFPGA.h"
+
 using namespace LSST::cRIO;
 
 TEST_CASE("Test MPU read input status", "[MPU]") {
@@ -230,3 +232,77 @@ TEST_CASE("Test MPU preset holding registers by simplymodbus.ca", "[MPU]") {
 
     REQUIRE_NOTHROW(mpu.processResponse(res.data(), res.size()));
 }
+
+TEST_CASE("Test MPU read holding registers into telemetry", "[MPU]") {
+    MPU mpu(1, 12);
+    mpu.readHoldingRegistersTelemetry(3, 3, 4, 101);
+
+    uint8_t* commands = mpu.getCommands();
+
+    REQUIRE(commands[0] == MPUCommands::WRITE);
+    REQUIRE(commands[1] == 8);
+    REQUIRE(commands[2] == 12);
+    REQUIRE(commands[3] == 3);
+    REQUIRE(commands[4] == 0);
+    REQUIRE(commands[5] == 3);
+    REQUIRE(commands[6] == 0);
+    REQUIRE(commands[7] == 3);
+    REQUIRE(commands[10] == MPUCommands::WAIT_MS);
+    REQUIRE(commands[11] == 101);
+    REQUIRE(commands[12] == MPUCommands::READ);
+    REQUIRE(commands[13] == 11);
+    REQUIRE(commands[14] == MPUCommands::CHECK_CRC);
+    REQUIRE(commands[15] == MPUCommands::TELEMETRY_16);
+    REQUIRE(commands[16] == 3);
+    REQUIRE(commands[17] == 4);
+    REQUIRE(commands[18] == MPUCommands::TELEMETRY_16);
+    REQUIRE(commands[19] == 5);
+    REQUIRE(commands[20] == 6);
+    REQUIRE(commands[21] == MPUCommands::TELEMETRY_16);
+    REQUIRE(commands[22] == 7);
+    REQUIRE(commands[23] == 8);
+
+    REQUIRE(mpu.containsRead() == false);
+    REQUIRE(mpu.getTelemetryLength() == 10);
+
+    std::vector<uint8_t> telemetry = {0xff, 0xff, 0xff, 0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+
+    REQUIRE_THROWS(mpu.processTelemetry(telemetry.data(), 9));
+    REQUIRE_NOTHROW(mpu.processTelemetry(telemetry.data(), telemetry.size()));
+
+    REQUIRE_THROWS(mpu.getRegister(2));
+    REQUIRE(mpu.getRegister(3) == 0x0102);
+    REQUIRE(mpu.getRegister(4) == 0x0304);
+    REQUIRE(mpu.getRegister(5) == 0x0506);
+    REQUIRE_THROWS(mpu.getRegister(6));
+
+    REQUIRE_THROWS(mpu.readHoldingRegistersTelemetry(10, 5, 250));
+
+    mpu.clearCommanded();
+    REQUIRE(mpu.getTelemetryLength() == 0);
+}
+
+TEST_CASE("Test concurrent MPUs commands", "[MPU]") {
+    TestFPGA fpga;
+
+    MPU mpu1a(1, 11);
+    MPU mpu1b(1, 12);
+    MPU mpu2(2, 21);
+
+    mpu1a.readHoldingRegisters(3, 1);
+    mpu1b.presetHoldingRegister(3, 4);
+    mpu2.readInputStatus(5, 8);
+
+    fpga.mpuCommands(std::vector<MPU*>({&mpu1a, &mpu1b, &mpu2}));
+
+    REQUIRE(fpga.mpuCalls.size() == 5);
+
+    // programs for both buses are written before outputs are read
+    REQUIRE(fpga.mpuCalls[0] == std::make_pair('W', static_cast<MPU*>(&mpu1a)));
+    REQUIRE(fpga.mpuCalls[1] == std::make_pair('W', static_cast<MPU*>(&mpu2)));
+    REQUIRE(fpga.mpuCalls[2] == std::make_pair('R', static_cast<MPU*>(&mpu1a)));
+    REQUIRE(fpga.mpuCalls[3] == std::make_pair('R', static_cast<MPU*>(&mpu2)));
+
+    // second MPU on the bus 1 doesn't read anything
+    REQUIRE(fpga.mpuCalls[4] == std::make_pair('W', static_cast<MPU*>(&mpu1b)));
+}
@@ -204,6 +204,8 @@ public:
     void recordChanges() { TestModbusBuffer::recordChanges(); }
     void pauseRecordChanges() { TestModbusBuffer::pauseRecordChanges(); }
     bool checkRecording(std::vector<uint8_t>& changed) { return TestModbusBuffer::checkRecording(changed); }
+    bool checkRecording(uint64_t& hash) { return TestModbusBuffer::checkRecording(hash); }
+    void setHashRecording(bool hashRecording) { TestModbusBuffer::setHashRecording(hashRecording); }
 };
 
 TEST_CASE("Call function with arguments", "[ModbusBuffer]") {
@@ -317,6 +319,84 @@ TEST_CASE("Test changed calculations", "[ModbusBuffer]") {
 
     readAll(2956, 48342);
     REQUIRE(mbuf.checkRecording(changed) == true);
+
+    uint64_t hash = 0;
+    REQUIRE_THROWS_AS(mbuf.checkRecording(hash), std::runtime_error);
+}
+
+TEST_CASE("Test changed hash calculations", "[ModbusBuffer]") {
+    TestBuffer mbuf;
+
+    mbuf.setHashRecording(true);
+
+    uint64_t hash = 0;
+
+    auto readAll = [&mbuf](int32_t nrp, uint32_t rp) {
+        mbuf.clear();
+        mbuf.testFunction(11, 23, 25, static_cast<uint8_t>(0x1a), static_cast<int32_t>(nrp),
+                          static_cast<uint32_t>(rp));
+        mbuf.reset();
+
+        REQUIRE(mbuf.read<uint8_t>() == 11);
+        REQUIRE(mbuf.read<uint8_t>() == 23);
+
+        REQUIRE_NOTHROW(mbuf.recordChanges());
+        REQUIRE(mbuf.read<uint8_t>() == 0x1a);
+
+        REQUIRE_NOTHROW(mbuf.pauseRecordChanges());
+        REQUIRE(mbuf.read<int32_t>() == nrp);
+        REQUIRE_NOTHROW(mbuf.recordChanges());
+
+        REQUIRE(mbuf.read<uint32_t>() == rp);
+        REQUIRE_NOTHROW(mbuf.checkCRC());
+        REQUIRE_NOTHROW(mbuf.readEndOfFrame());
+    };
+
+    readAll(-977453, 87346);
+    REQUIRE(mbuf.checkRecording(hash) == false);
+    REQUIRE(hash != 0);
+
+    readAll(-977453, 87346);
+    REQUIRE(mbuf.checkRecording(hash) == true);
+
+    readAll(2956, 87346);
+    REQUIRE(mbuf.checkRecording(hash) == true);
+
+    readAll(2956, 48342);
+    REQUIRE(mbuf.checkRecording(hash) == false);
+
+    readAll(2956, 48342);
+    REQUIRE(mbuf.checkRecording(hash) == true);
+
+    readAll(2956, 87346);
+    REQUIRE(mbuf.checkRecording(hash) == false);
+
+    std::vector<uint8_t> changed;
+    REQUIRE_THROWS_AS(mbuf.checkRecording(changed), std::runtime_error);
+}
+
+TEST_CASE("CRC delta", "[ModbusBuffer::CRC]") {
+    std::string message("Calculating CRC is as easy as answering 42.");
+
+    auto calculate = [](const std::string& m) {
+        TestModbusBuffer::CRC crc;
+        for (auto d : m) {
+            crc.add(d);
+        }
+        return crc.get();
+    };
+
+    uint16_t original = calculate(message);
+    REQUIRE(original == 0x2879);
+
+    std::string changed(message);
+    changed[3] = 'C';
+    changed[42] = '3';
+
+    uint16_t delta = TestModbusBuffer::CRC::delta(message[3] ^ changed[3], message.length() - 4) ^
+                     TestModbusBuffer::CRC::delta(message[42] ^ changed[42], message.length() - 43);
+
+    REQUIRE((original ^ delta) == calculate(changed));
 }
 
 TEST_CASE("CRC class", "[ModbusBuffer::CRC]") {
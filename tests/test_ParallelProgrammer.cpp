@@ -0,0 +1,263 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests concurrent ILC programming.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <set>
+#include <string.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/ParallelProgrammer.h>
+#include <cRIO/SimulatedILC.h>
+
+#include <TestFPGA.h>
+
+using namespace LSST::cRIO;
+
+/**
+ * Simulates FPGA with ILCs on multiple buses, accepting firmware updates.
+ * ILCs listed in failErase reply with exception to application erase.
+ */
+class ProgramFPGA : public MultiBusFPGA {
+public:
+    // bus -> address -> ILC mode
+    std::map<uint8_t, std::map<uint8_t, uint8_t>> modes;
+    // bus -> address -> firmware identity
+    std::map<uint8_t, std::map<uint8_t, ILC::FirmwareRevision>> revisions;
+    // bus -> address -> number of written pages
+    std::map<uint8_t, std::map<uint8_t, int>> pages;
+    std::set<uint8_t> failErase;
+
+protected:
+    bool simulateCommand(uint8_t bus, uint8_t address, uint8_t func, ILC& command,
+                         SimulatedILC& response) override {
+        response.write(address);
+        switch (func) {
+            case 17: {
+                command.checkCRC();
+                auto& revision = revisions[bus][address];
+                response.write(func);
+                response.write<uint8_t>(12 + revision.name.length());
+                for (int i = 0; i < 6; i++) {
+                    response.write<uint8_t>(0);
+                }
+                response.write<uint8_t>(2);
+                response.write<uint8_t>(0);
+                response.write<uint8_t>(0);
+                response.write<uint8_t>(0);
+                response.write(revision.majorRev);
+                response.write(revision.minorRev);
+                for (auto c : revision.name) {
+                    response.write<uint8_t>(c);
+                }
+                break;
+            }
+            case 18:
+                command.checkCRC();
+                response.write(func);
+                response.write(modes[bus][address]);
+                response.write<uint16_t>(0);
+                response.write<uint16_t>(0);
+                break;
+            case 65: {
+                uint16_t mode = command.read<uint16_t>();
+                command.checkCRC();
+                modes[bus][address] = mode == ILC::ClearFaults ? ILC::Standby : mode;
+                response.write(func);
+                response.write(mode);
+                break;
+            }
+            case 100:
+                command.read<uint16_t>();
+                command.read<uint16_t>();
+                command.read<uint16_t>();
+                command.read<uint16_t>();
+                command.checkCRC();
+                response.write(func);
+                break;
+            case 101:
+                command.checkCRC();
+                if (failErase.count(address) > 0) {
+                    response.write<uint8_t>(229);
+                    response.write<uint8_t>(1);
+                } else {
+                    response.write(func);
+                }
+                break;
+            case 102: {
+                command.read<uint16_t>();
+                uint16_t len = command.read<uint16_t>();
+                for (int i = 0; i < len; i++) {
+                    command.read<uint8_t>();
+                }
+                command.checkCRC();
+                pages[bus][address]++;
+                response.write(func);
+                break;
+            }
+            case 103:
+                command.checkCRC();
+                response.write(func);
+                response.write<uint16_t>(0);
+                break;
+            default:
+                FAIL("Unexpected function " << +func);
+        }
+        return true;
+    }
+};
+
+class CountingProgrammer : public ParallelProgrammer {
+public:
+    CountingProgrammer(FPGA* fpga) : ParallelProgrammer(fpga), steps(0), finished(0) {}
+
+    int steps;
+    int finished;
+
+protected:
+    void processProgress(PrintILC* ilc, uint8_t address, const char* step, float progress) override {
+        REQUIRE(progress >= 0);
+        REQUIRE(progress <= 1);
+        steps++;
+    }
+
+    void processResult(const Result& result) override { finished++; }
+};
+
+TEST_CASE("Program ILCs on multiple buses", "[ParallelProgrammer]") {
+    IntelHex hex;
+    hex.load("data/ILC-3.hex");
+
+    ProgramFPGA fpga;
+    PrintILC busA(1), busB(2);
+
+    fpga.modes[1][1] = ILC::Enabled;
+    fpga.modes[1][2] = ILC::Standby;
+    fpga.modes[1][3] = ILC::Fault;
+    fpga.modes[2][7] = ILC::Disabled;
+
+    fpga.failErase = {2};
+
+    CountingProgrammer programmer(&fpga);
+    programmer.add(&busA, 1);
+    programmer.add(&busB, 7);
+    programmer.add(&busA, 2);
+    programmer.add(&busA, 3);
+
+    auto results = programmer.program(hex);
+
+    REQUIRE(results.size() == 4);
+    REQUIRE(programmer.finished == 4);
+    REQUIRE(programmer.steps > 0);
+
+    int pages = fpga.pages[1][1];
+    REQUIRE(pages > 0);
+    REQUIRE(fpga.pages[1][3] == pages);
+    REQUIRE(fpga.pages[2][7] == pages);
+    REQUIRE(fpga.pages[1][2] == 0);
+
+    for (auto r : results) {
+        if (r.ilc == &busA && r.address == 2) {
+            REQUIRE(r.success == false);
+            REQUIRE(fpga.modes[1][2] == ILC::FirmwareUpdate);
+        } else {
+            REQUIRE(r.success == true);
+            REQUIRE(fpga.modes[r.ilc->getBus()][r.address] == ILC::Disabled);
+        }
+    }
+
+    // the ILC on bus B was programmed together with the first ILC on bus A
+    REQUIRE(fpga.parallelTransactions >= static_cast<unsigned int>(pages));
+}
+
+TEST_CASE("Multiple pages per transaction", "[ParallelProgrammer]") {
+    IntelHex hex;
+    hex.load("data/ILC-3.hex");
+
+    ProgramFPGA fpga;
+    PrintILC ilc(1);
+
+    REQUIRE_THROWS_AS(ilc.setPagesPerTransaction(0), std::out_of_range);
+    REQUIRE_THROWS_AS(ilc.setPagesPerTransaction(1, 100), std::out_of_range);
+
+    fpga.modes[1][8] = ILC::Standby;
+
+    ilc.programILC(&fpga, 8, hex);
+    int pages = fpga.pages[1][8];
+    unsigned int singlePage = fpga.transactions;
+
+    REQUIRE(pages > 20);
+
+    fpga.transactions = 0;
+    fpga.modes[1][8] = ILC::Standby;
+    ilc.setPagesPerTransaction(8);
+    ilc.programILC(&fpga, 8, hex);
+    REQUIRE(fpga.pages[1][8] == 2 * pages);
+    REQUIRE(fpga.transactions == singlePage - pages + (pages + 7) / 8);
+
+    // transaction length limits number of pages
+    fpga.transactions = 0;
+    fpga.modes[1][8] = ILC::Standby;
+    ilc.setPagesPerTransaction(8, 2 * 202 + 100);
+    ilc.programILC(&fpga, 8, hex);
+    REQUIRE(fpga.pages[1][8] == 3 * pages);
+    REQUIRE(fpga.transactions == singlePage - pages + (pages + 1) / 2);
+}
+
+TEST_CASE("Skip ILCs running target firmware", "[ParallelProgrammer]") {
+    IntelHex hex;
+    hex.load("data/ILC-3.hex");
+
+    ProgramFPGA fpga;
+    PrintILC ilc(1);
+
+    for (uint8_t address = 1; address <= 3; address++) {
+        fpga.modes[1][address] = ILC::Enabled;
+    }
+    fpga.revisions[1][1] = ILC::FirmwareRevision{"PFA", 3, 2};
+    fpga.revisions[1][2] = ILC::FirmwareRevision{"PFA", 3, 1};
+    fpga.revisions[1][3] = ILC::FirmwareRevision{"TS", 3, 2};
+
+    ilc.setTargetFirmware("PFA", 3, 2);
+
+    ParallelProgrammer programmer(&fpga);
+    for (uint8_t address = 1; address <= 3; address++) {
+        programmer.add(&ilc, address);
+    }
+
+    auto results = programmer.program(hex);
+    REQUIRE(results.size() == 3);
+    for (auto r : results) {
+        REQUIRE(r.success == true);
+        REQUIRE(r.skipped == (r.address == 1));
+    }
+
+    REQUIRE(fpga.pages[1][1] == 0);
+    REQUIRE(fpga.pages[1][2] > 0);
+    REQUIRE(fpga.pages[1][3] > 0);
+    REQUIRE(fpga.modes[1][1] == ILC::Enabled);
+
+    ilc.setForceProgramming(true);
+    ilc.programILC(&fpga, 1, hex);
+    REQUIRE(ilc.isProgramSkipped() == false);
+    REQUIRE(fpga.pages[1][1] == fpga.pages[1][2]);
+}
@@ -0,0 +1,265 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests Pneumatic ILC functions.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/PneumaticILC.h>
+
+using namespace LSST::cRIO;
+
+class TestPneumaticILC : public PneumaticILC {
+public:
+    TestPneumaticILC() {
+        responseAddress = 0;
+        responseStatus = 0;
+        responsePrimary = NAN;
+        responseSecondary = NAN;
+        arraysCallCounter = 0;
+    }
+
+    unsigned int arraysCallCounter;
+
+    uint8_t responseAddress;
+    uint8_t responseStatus;
+    float responsePrimary;
+    float responseSecondary;
+
+    int32_t readI24() {
+        int32_t ret = read<uint8_t>() << 16;
+        ret |= read<uint8_t>() << 8;
+        ret |= read<uint8_t>();
+        if (ret & 0x800000) {
+            ret |= 0xFF000000;
+        }
+        return ret;
+    }
+
+protected:
+    void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
+                         uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
+                         uint8_t minorRev, std::string firmwareName) override {}
+
+    void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override {}
+
+    void processChangeILCMode(uint8_t address, uint16_t mode) override {}
+
+    void processSetTempILCAddress(uint8_t address, uint8_t newAddress) override {}
+
+    void processResetServer(uint8_t address) override {}
+
+    void processForceStatus(uint8_t address, uint8_t status, float primaryLoadCellForce,
+                            float secondaryLoadCellForce) override {
+        responseAddress = address;
+        responseStatus = status;
+        responsePrimary = primaryLoadCellForce;
+        responseSecondary = secondaryLoadCellForce;
+    }
+
+    void processForceStatusArrays() override { arraysCallCounter++; }
+};
+
+TEST_CASE("Unicast force demand", "[PneumaticILC]") {
+    TestPneumaticILC ilc;
+
+    ilc.setForceDemand(12, false, 12.3456, 15);
+    ilc.setForceDemand(23, true, -12.3456, 1.2344);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 12);
+    REQUIRE(ilc.read<uint8_t>() == 75);
+    REQUIRE(ilc.read<uint8_t>() == 0x00);
+    REQUIRE(ilc.readI24() == 12346);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 1800);
+
+    REQUIRE(ilc.read<uint8_t>() == 23);
+    REQUIRE(ilc.read<uint8_t>() == 75);
+    REQUIRE(ilc.read<uint8_t>() == 0xFF);
+    REQUIRE(ilc.readI24() == -12346);
+    REQUIRE(ilc.readI24() == 1234);
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readWaitForRx() == 1800);
+}
+
+TEST_CASE("Broadcast force demand", "[PneumaticILC]") {
+    TestPneumaticILC ilc;
+
+    REQUIRE_THROWS(ilc.setForceActuator(0, 1));
+    REQUIRE_THROWS(ilc.setForceActuator(49, 1));
+    REQUIRE_THROWS(ilc.setForceActuator(1, FA_COUNT));
+
+    ilc.setForceActuator(1, 101);
+    ilc.setForceActuator(16, 0);
+    ilc.setForceActuator(17, 155);
+    ilc.setForceActuator(48, 3);
+
+    float primary[FA_COUNT];
+    float secondary[FA_COUNT];
+    for (int i = 0; i < FA_COUNT; i++) {
+        primary[i] = i * 1.5;
+        secondary[i] = -i * 0.25;
+    }
+    primary[3] = 10000;
+    secondary[3] = -10000;
+
+    ilc.broadcastForceDemand(true, primary, secondary);
+
+    ilc.reset();
+
+    REQUIRE(ilc.read<uint8_t>() == 248);
+    REQUIRE(ilc.read<uint8_t>() == 75);
+    REQUIRE(ilc.read<uint8_t>() == 1);
+    REQUIRE(ilc.read<uint8_t>() == 0xFF);
+
+    for (int address = 1; address <= 16; address++) {
+        switch (address) {
+            case 1:
+                REQUIRE(ilc.readI24() == 151500);
+                break;
+            default:
+                // address 16 is assigned to actuator with 0 N demand
+                REQUIRE(ilc.readI24() == 0);
+        }
+    }
+
+    for (int address = 17; address <= 48; address++) {
+        switch (address) {
+            case 17:
+                REQUIRE(ilc.readI24() == 232500);
+                REQUIRE(ilc.readI24() == -38750);
+                break;
+            case 48:
+                // saturated
+                REQUIRE(ilc.readI24() == 0x7FFFFF);
+                REQUIRE(ilc.readI24() == -0x800000);
+                break;
+            default:
+                REQUIRE(ilc.readI24() == 0);
+                REQUIRE(ilc.readI24() == 0);
+        }
+    }
+
+    REQUIRE_NOTHROW(ilc.checkCRC());
+    REQUIRE_NOTHROW(ilc.readEndOfFrame());
+    REQUIRE(ilc.readDelay() == 150);
+    REQUIRE(ilc.endOfBuffer());
+}
+
+TEST_CASE("Parse force status responses", "[PneumaticILC]") {
+    TestPneumaticILC ilc, response;
+
+    ilc.reportForceStatus(8);
+    ilc.reportForceStatus(33);
+
+    response.write<uint8_t>(8);
+    response.write<uint8_t>(76);
+    response.write<uint8_t>(0x12);
+    response.write<float>(-123.456);
+    response.writeCRC();
+
+    response.write<uint8_t>(33);
+    response.write<uint8_t>(76);
+    response.write<uint8_t>(0x34);
+    response.write<float>(654.321);
+    response.write<float>(-0.25);
+    response.writeCRC();
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), 9));
+
+    REQUIRE(ilc.responseAddress == 8);
+    REQUIRE(ilc.responseStatus == 0x12);
+    REQUIRE(ilc.responsePrimary == -123.456f);
+    REQUIRE(std::isnan(ilc.responseSecondary));
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer() + 9, response.getLength() - 9));
+
+    REQUIRE(ilc.responseAddress == 33);
+    REQUIRE(ilc.responseStatus == 0x34);
+    REQUIRE(ilc.responsePrimary == 654.321f);
+    REQUIRE(ilc.responseSecondary == -0.25f);
+
+    REQUIRE_NOTHROW(ilc.checkCommandedEmpty());
+}
+
+TEST_CASE("Decode force status into arrays", "[PneumaticILC]") {
+    TestPneumaticILC ilc, response;
+
+    ForceStatusArrays arrays;
+
+    ilc.setForceActuator(8, 12);
+    ilc.setForceActuator(33, 133);
+    ilc.setForceStatusArrays(&arrays);
+
+    auto addResponse = [&ilc, &response](uint8_t address, uint8_t status, float primary, float secondary) {
+        ilc.reportForceStatus(address);
+
+        response.write<uint8_t>(address);
+        response.write<uint8_t>(76);
+        response.write<uint8_t>(status);
+        response.write<float>(primary);
+        if (PneumaticILC::isDAA(address)) {
+            response.write<float>(secondary);
+        }
+        response.writeCRC();
+    };
+
+    addResponse(8, 0x12, -123.456, NAN);
+    addResponse(40, 0x56, 0.5, 1.5);
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    REQUIRE(arrays.reported.count() == 1);
+    REQUIRE(arrays.reported[12] == true);
+    REQUIRE(arrays.status[12] == 0x12);
+    REQUIRE(arrays.primaryForce[12] == -123.456f);
+    REQUIRE(std::isnan(arrays.secondaryForce[12]));
+
+    // address without assigned actuator is reported with callback
+    REQUIRE(ilc.responseAddress == 40);
+    REQUIRE(ilc.responseStatus == 0x56);
+
+    // not all actuators reported
+    ilc.endOfCycle();
+    REQUIRE(ilc.arraysCallCounter == 0);
+
+    response.clear();
+    addResponse(8, 0x12, -123.456, NAN);
+    addResponse(33, 0x34, 654.321, -0.25);
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    REQUIRE(arrays.reported.count() == 2);
+    REQUIRE(arrays.status[133] == 0x34);
+    REQUIRE(arrays.primaryForce[133] == 654.321f);
+    REQUIRE(arrays.secondaryForce[133] == -0.25f);
+
+    ilc.endOfCycle();
+    REQUIRE(ilc.arraysCallCounter == 1);
+
+    ilc.endOfCycle();
+    REQUIRE(ilc.arraysCallCounter == 1);
+}
@@ -0,0 +1,218 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests rate group poll scheduler.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/PollScheduler.h>
+
+using namespace LSST::cRIO;
+
+class TestILC : public ILC {
+public:
+    TestILC(uint8_t bus) : ILC(bus) {}
+
+protected:
+    void processServerID(uint8_t address, uint64_t uniqueID, uint8_t ilcAppType, uint8_t networkNodeType,
+                         uint8_t ilcSelectedOptions, uint8_t networkNodeOptions, uint8_t majorRev,
+                         uint8_t minorRev, std::string firmwareName) override {}
+    void processServerStatus(uint8_t address, uint8_t mode, uint16_t status, uint16_t faults) override {}
+    void processChangeILCMode(uint8_t address, uint16_t mode) override {}
+    void processSetTempILCAddress(uint8_t address, uint8_t newAddress) override {}
+    void processResetServer(uint8_t address) override {}
+};
+
+TEST_CASE("Rate groups", "[PollScheduler]") {
+    TestILC ilc1(1), ilc2(2);
+
+    PollScheduler scheduler(50);
+
+    REQUIRE_THROWS_AS(scheduler.addRateGroup(&ilc1, 0, {1}, nullptr), std::out_of_range);
+    REQUIRE_THROWS_AS(scheduler.addRateGroup(&ilc1, 51, {1}, nullptr), std::out_of_range);
+
+    std::vector<std::pair<char, uint8_t>> polls;
+
+    auto poll = [&polls](char group) {
+        return [&polls, group](uint8_t address) { polls.emplace_back(group, address); };
+    };
+
+    std::vector<uint8_t> addresses;
+    for (uint8_t a = 1; a <= 10; a++) {
+        addresses.push_back(a);
+    }
+
+    // lower rates added first - shall be still polled after higher rates
+    scheduler.addRateGroup(&ilc1, 1, addresses, poll('S'));
+    scheduler.addRateGroup(&ilc1, 10, addresses, poll('T'));
+    scheduler.addRateGroup(&ilc1, 50, addresses, poll('F'));
+    scheduler.addRateGroup(&ilc2, 50, {5}, [&ilc2](uint8_t address) { ilc2.reportServerStatus(address); });
+
+    std::map<char, std::map<uint8_t, int>> counts;
+
+    for (int c = 0; c < 50; c++) {
+        polls.clear();
+
+        if (c == 7) {
+            scheduler.pollOnDemand(&ilc1, 3, poll('C'));
+        }
+
+        auto ilcs = scheduler.cycle();
+        REQUIRE(ilcs.size() == 2);
+        REQUIRE(ilc2.getLength() > 0);
+
+        // 10 force, 2 thermal, 0 or 1 status, (calibration) - load is flat
+        REQUIRE(polls.size() >= 12);
+        REQUIRE(polls.size() <= (c == 7 ? 14 : 13));
+
+        for (size_t i = 0; i < polls.size(); i++) {
+            counts[polls[i].first][polls[i].second]++;
+            if (i < 10) {
+                REQUIRE(polls[i].first == 'F');
+            } else if (i < 12) {
+                REQUIRE(polls[i].first == 'T');
+            }
+        }
+        if (c == 7) {
+            REQUIRE(polls.back().first == 'C');
+            REQUIRE(polls.back().second == 3);
+        }
+    }
+
+    REQUIRE(scheduler.getCycle() == 50);
+
+    for (uint8_t a = 1; a <= 10; a++) {
+        REQUIRE(counts['F'][a] == 50);
+        REQUIRE(counts['T'][a] == 10);
+        REQUIRE(counts['S'][a] == 1);
+    }
+    REQUIRE(counts['C'].size() == 1);
+}
+
+TEST_CASE("Sensor readouts", "[PollScheduler]") {
+    TestILC ilc(1), response(1);
+
+    // confirm 1 kHz ADC sample rate for address 1, address 2 rate is unknown
+    ilc.setADCScanRate(1, 5);
+    response.write<uint8_t>(1);
+    response.write<uint8_t>(80);
+    response.write<uint8_t>(5);
+    response.writeCRC();
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    PollScheduler scheduler(2000);
+
+    std::map<uint8_t, int> counts;
+    int statusCount = 0;
+
+    scheduler.addRateGroup(&ilc, 2000, {1, 2}, [&counts](uint8_t address) { counts[address]++; }, true);
+
+    auto now = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < 20; c++) {
+        auto ilcs = scheduler.cycle(now + std::chrono::microseconds(500 * c));
+        REQUIRE(ilcs.size() == 1);
+    }
+
+    // new sample is acquired every other cycle
+    REQUIRE(counts[1] == 10);
+    REQUIRE(counts[2] == 20);
+
+    // status polls aren't gated by sensor samples
+    PollScheduler statusScheduler(2000);
+    statusScheduler.addRateGroup(&ilc, 2000, {1}, [&statusCount](uint8_t address) { statusCount++; });
+
+    for (int c = 0; c < 20; c++) {
+        statusScheduler.cycle(now + std::chrono::microseconds(500 * c));
+    }
+
+    REQUIRE(statusCount == 20);
+}
+
+TEST_CASE("Skipped sensor readouts are retried", "[PollScheduler]") {
+    TestILC ilc(1), response(1);
+
+    // 1 kHz ADC sample rate
+    ilc.setADCScanRate(1, 5);
+    response.write<uint8_t>(1);
+    response.write<uint8_t>(80);
+    response.write<uint8_t>(5);
+    response.writeCRC();
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    PollScheduler scheduler(2000);
+
+    std::vector<uint64_t> polled;
+
+    scheduler.addRateGroup(
+            &ilc, 1000, {1}, [&](uint8_t address) { polled.push_back(scheduler.getCycle()); }, true);
+
+    auto now = std::chrono::steady_clock::now();
+
+    // cycles run slightly faster than 2 kHz, so readouts scheduled every
+    // other cycle find the sample not yet ready
+    for (int c = 0; c < 10; c++) {
+        scheduler.cycle(now + std::chrono::microseconds(490 * c));
+    }
+
+    // skipped readout is retried in the next cycles until the sample is
+    // ready, without waiting a divider period ({0, 4, 8} without retry)
+    REQUIRE(polled == std::vector<uint64_t>({0, 3, 6, 9}));
+}
+
+TEST_CASE("Freeze broadcast with sensor readouts", "[PollScheduler]") {
+    TestILC ilc(1);
+    ilc.setFreezeCycle(true);
+
+    PollScheduler scheduler(50);
+
+    scheduler.addRateGroup(&ilc, 50, {2}, [&ilc](uint8_t address) { ilc.reportServerStatus(address); });
+    scheduler.addRateGroup(
+            &ilc, 10, {1}, [&ilc](uint8_t address) { ilc.reportServerStatus(address); }, true);
+
+    int freezes = 0;
+
+    for (int c = 0; c < 50; c++) {
+        auto ilcs = scheduler.cycle();
+        REQUIRE(ilcs.size() == 1);
+
+        ilc.reset();
+        // status poll of the faster group is written first
+        REQUIRE(ilc.read<uint8_t>() == 2);
+        REQUIRE(ilc.read<uint8_t>() == 18);
+        REQUIRE_NOTHROW(ilc.checkCRC());
+        REQUIRE_NOTHROW(ilc.readEndOfFrame());
+        REQUIRE(ilc.readWaitForRx() == 270);
+
+        if (ilc.endOfBuffer()) {
+            continue;
+        }
+
+        // freeze broadcast precedes sensor readout
+        REQUIRE(ilc.read<uint8_t>() == 248);
+        REQUIRE(ilc.read<uint8_t>() == 68);
+        freezes++;
+    }
+
+    REQUIRE(freezes == 10);
+}
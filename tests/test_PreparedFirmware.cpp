@@ -0,0 +1,74 @@
+/*
+ * This file is part of LSST cRIOcpp test suite. Tests firmware prepared for ILC programming.
+ *
+ * Developed for the Vera C. Rubin Observatory Telescope & Site Software Systems.
+ * This product includes software developed by the Vera C.Rubin Observatory Project
+ * (https://www.lsst.org). See the COPYRIGHT file at the top-level directory of
+ * this distribution for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cRIO/PreparedFirmware.h>
+#include <cRIO/PrintILC.h>
+
+using namespace LSST::cRIO;
+
+TEST_CASE("Prepared page frames", "[PreparedFirmware]") {
+    IntelHex hex;
+    hex.load("data/ILC-3.hex");
+
+    PreparedFirmware firmware(hex);
+
+    uint16_t startAddress;
+    std::vector<uint8_t> data = hex.getData(startAddress);
+
+    ModbusBuffer::CRC crc;
+    for (auto d : data) {
+        crc.add(d);
+    }
+
+    REQUIRE(firmware.getStartAddress() == startAddress);
+    REQUIRE(firmware.getDataLength() == data.size());
+    REQUIRE(firmware.getDataCRC() == crc.get());
+    REQUIRE(firmware.getPageCount() == (data.size() + 255) / 256);
+
+    data.resize(firmware.getPageCount() * 256, 0xFF);
+
+    PrintILC ilc(1);
+
+    for (size_t page = 0; page < firmware.getPageCount(); page++) {
+        uint8_t pageData[192];
+        for (int i = 0; i < 64; i++) {
+            for (int j = 0; j < 3; j++) {
+                pageData[i * 3 + j] = data[page * 256 + i * 4 + j];
+            }
+        }
+
+        for (uint8_t address : {0, 1, 18, 138, 247}) {
+            ilc.clear();
+            ilc.writeApplicationPage(address, startAddress + page * 256, 192, pageData);
+
+            uint16_t frame[PreparedFirmware::PAGE_FRAME_LENGTH];
+            firmware.writePageFrame(page, address, frame);
+
+            REQUIRE(ilc.getLength() == PreparedFirmware::PAGE_FRAME_LENGTH + 2);
+            for (size_t i = 0; i < PreparedFirmware::PAGE_FRAME_LENGTH; i++) {
+                REQUIRE(frame[i] == ilc.getBuffer()[i]);
+            }
+        }
+    }
+}
@@ -64,5 +64,10 @@ TEST_CASE("Test program ILC", "[PrintILC]") {
                           0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     fpga.setPages(pages);
 
+    // programming not started
+    REQUIRE(ilc.getProgramCRC() == 0);
+
     REQUIRE_NOTHROW(ilc.programILC(&fpga, 8, hex));
+
+    REQUIRE(ilc.getProgramCRC() == PreparedFirmware(hex).getDataCRC());
 }
@@ -36,8 +36,11 @@ public:
         responseDifferentialTemperature = std::nan("f");
         responseFanRPM = 0;
         responseAbsoluteTemperature = std::nan("f");
+        thermalStatusCallCounter = 0;
     }
 
+    unsigned int thermalStatusCallCounter;
+
     uint8_t responseStatus;
     float responseDifferentialTemperature;
     uint8_t responseFanRPM;
@@ -58,11 +61,21 @@ protected:
 
     void processThermalStatus(uint8_t address, uint8_t status, float differentialTemperature, uint8_t fanRPM,
                               float absoluteTemperature) override {
+        thermalStatusCallCounter++;
         responseStatus = status;
         responseDifferentialTemperature = differentialTemperature;
         responseFanRPM = fanRPM;
         responseAbsoluteTemperature = absoluteTemperature;
     }
+
+    void processThermalStatusFrame(const ThermalStatusFrame& frame) override {
+        frameCallCounter++;
+        lastFrame = frame;
+    }
+
+public:
+    unsigned int frameCallCounter = 0;
+    ThermalStatusFrame lastFrame;
 };
 
 TEST_CASE("Test setThermalStatus", "[ThermalILC]") {
@@ -105,6 +118,58 @@ TEST_CASE("Broadcast set heater & fan target values", "[ThermalILC]") {
     REQUIRE(ilc.readDelay() == 450);
 }
 
+TEST_CASE("Broadcast only changed heater & fan target values", "[ThermalILC]") {
+    uint8_t heaters[NUM_TS_ILC];
+    uint8_t fans[NUM_TS_ILC];
+    for (int i = 0; i < NUM_TS_ILC; i++) {
+        heaters[i] = i;
+        fans[i] = 255 - i;
+    }
+
+    TestThermalILC ilc;
+
+    ilc.setDemandRefreshInterval(std::chrono::hours(1));
+
+    REQUIRE(ilc.broadcastThermalDemand(heaters, fans) == true);
+
+    size_t frameLength = ilc.getLength();
+
+    REQUIRE(ilc.broadcastThermalDemand(heaters, fans) == false);
+    REQUIRE(ilc.getLength() == frameLength);
+
+    heaters[11] = 0xff;
+    fans[95] = 0x12;
+
+    REQUIRE(ilc.broadcastThermalDemand(heaters, fans) == true);
+    REQUIRE(ilc.getLength() == 2 * frameLength);
+
+    ilc.reset();
+
+    auto checkFrame = [&ilc](uint8_t counter, uint8_t heater11, uint8_t fan95) {
+        REQUIRE(ilc.read<uint8_t>() == 250);
+        REQUIRE(ilc.read<uint8_t>() == 88);
+        REQUIRE(ilc.read<uint8_t>() == counter);
+        for (int i = 0; i < NUM_TS_ILC; i++) {
+            REQUIRE(ilc.read<uint8_t>() == (i == 11 ? heater11 : i));
+            REQUIRE(ilc.read<uint8_t>() == (i == 95 ? fan95 : 255 - i));
+        }
+        REQUIRE_NOTHROW(ilc.checkCRC());
+        REQUIRE_NOTHROW(ilc.readEndOfFrame());
+        REQUIRE(ilc.readDelay() == 450);
+    };
+
+    checkFrame(1, 11, 255 - 95);
+    checkFrame(2, 0xff, 0x12);
+
+    ilc.clear();
+    ilc.setDemandRefreshInterval(std::chrono::steady_clock::duration::zero());
+
+    REQUIRE(ilc.broadcastThermalDemand(heaters, fans) == true);
+
+    ilc.reset();
+    checkFrame(3, 0xff, 0x12);
+}
+
 TEST_CASE("Test parsing of thermal status response", "[ThermalILC]") {
     TestThermalILC ilc, response;
 
@@ -133,3 +198,106 @@ TEST_CASE("Test parsing of thermal status response", "[ThermalILC]") {
     REQUIRE(ilc.responseFanRPM == 0xff);
     REQUIRE(ilc.responseAbsoluteTemperature == 215.567f);
 }
+
+TEST_CASE("Filter thermal status changes", "[ThermalILC]") {
+    TestThermalILC ilc, response;
+
+    ilc.setDeadband(89, 1, 0.1);
+    ilc.setDeadband(89, 3, 0.5);
+
+    auto sendResponse = [&ilc, &response](uint8_t status, float differentialTemperature,
+                                          float absoluteTemperature) {
+        ilc.reportThermalStatus(77);
+
+        response.clear();
+        response.write<uint8_t>(77);
+        response.write<uint8_t>(89);
+        response.write<uint8_t>(status);
+        response.write<float>(differentialTemperature);
+        response.write<uint8_t>(0xff);
+        response.write<float>(absoluteTemperature);
+        response.writeCRC();
+
+        REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+    };
+
+    sendResponse(1, 0.5, 20.5);
+    REQUIRE(ilc.thermalStatusCallCounter == 1);
+
+    sendResponse(1, 0.55, 20.9);
+    REQUIRE(ilc.thermalStatusCallCounter == 1);
+    REQUIRE(ilc.responseAbsoluteTemperature == 20.5f);
+
+    sendResponse(1, 0.55, 21.1);
+    REQUIRE(ilc.thermalStatusCallCounter == 2);
+    REQUIRE(ilc.responseAbsoluteTemperature == 21.1f);
+
+    sendResponse(2, 0.55, 21.1);
+    REQUIRE(ilc.thermalStatusCallCounter == 3);
+    REQUIRE(ilc.responseStatus == 2);
+
+    // reply to unicast thermal demand isn't filtered
+    ilc.setThermalDemand(77, 10, 20);
+    response.clear();
+    response.write<uint8_t>(77);
+    response.write<uint8_t>(88);
+    response.write<uint8_t>(2);
+    response.write<float>(0.55);
+    response.write<uint8_t>(0xff);
+    response.write<float>(21.1);
+    response.writeCRC();
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+    REQUIRE(ilc.thermalStatusCallCounter == 4);
+}
+
+TEST_CASE("Thermal status frame", "[ThermalILC]") {
+    TestThermalILC ilc, response;
+
+    ilc.setFrameMode(true);
+    ilc.setFrameIndex(96, 0);
+    ilc.setFrameIndex(1, 0xFF);
+
+    auto addResponse = [&ilc, &response](uint8_t address, uint8_t status, float absoluteTemperature) {
+        ilc.reportThermalStatus(address);
+
+        response.write<uint8_t>(address);
+        response.write<uint8_t>(89);
+        response.write<uint8_t>(status);
+        response.write<float>(0.5);
+        response.write<uint8_t>(address);
+        response.write<float>(absoluteTemperature);
+        response.writeCRC();
+    };
+
+    addResponse(96, 1, 20.5);
+    addResponse(12, 2, 21.5);
+    addResponse(1, 3, 22.5);
+
+    REQUIRE_NOTHROW(ilc.processResponse(response.getBuffer(), response.getLength()));
+
+    // ILC not in frame is reported with processThermalStatus
+    REQUIRE(ilc.thermalStatusCallCounter == 1);
+    REQUIRE(ilc.responseStatus == 3);
+    REQUIRE(ilc.frameCallCounter == 0);
+
+    ilc.endOfCycle();
+
+    REQUIRE(ilc.frameCallCounter == 1);
+    REQUIRE(ilc.lastFrame.valid.count() == 2);
+    REQUIRE(ilc.lastFrame.valid[0] == true);
+    REQUIRE(ilc.lastFrame.valid[11] == true);
+
+    REQUIRE(ilc.lastFrame.status[0] == 1);
+    REQUIRE(ilc.lastFrame.fanRPM[0] == 96);
+    REQUIRE(ilc.lastFrame.absoluteTemperature[0] == 20.5);
+
+    REQUIRE(ilc.lastFrame.status[11] == 2);
+    REQUIRE(ilc.lastFrame.differentialTemperature[11] == 0.5);
+    REQUIRE(ilc.lastFrame.fanRPM[11] == 12);
+    REQUIRE(ilc.lastFrame.absoluteTemperature[11] == 21.5);
+
+    // no response received, frame isn't published
+    ilc.endOfCycle();
+    REQUIRE(ilc.frameCallCounter == 1);
+}